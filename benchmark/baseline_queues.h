@@ -0,0 +1,240 @@
+#ifndef BASELINE_QUEUES_H
+#define BASELINE_QUEUES_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Baseline queues for benchmark_queue.
+//
+// Every queue here follows the same concept as SPMCQueue so they can be driven by the same workloads:
+// - bool enqueue(const uint8_t* data, size_t size): false if the queue is full.
+// - bool dequeue(uint8_t* buffer, size_t& size): false if there is nothing to read.
+// All of them preallocate their slots with the same 64-byte payload as Block, so no queue pays for
+// an allocation or an extra copy the others don't.
+
+// Fixed-size slot shared by the baselines.
+struct BaselineSlot {
+    size_t mSize = 0;
+    uint8_t mData[64];
+};
+
+// Bounded ring of preallocated slots guarded by a std::mutex.
+class MutexRingQueue {
+public:
+    explicit MutexRingQueue(size_t capacity) : mSlots(capacity) {}
+
+    bool enqueue(const uint8_t* data, size_t size) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mHead - mTail == mSlots.size()) return false;
+
+        BaselineSlot& slot = mSlots[mHead % mSlots.size()];
+        std::memcpy(slot.mData, data, size);
+        slot.mSize = size;
+        ++mHead;
+        return true;
+    }
+
+    bool dequeue(uint8_t* buffer, size_t& size) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mHead == mTail) return false;
+
+        BaselineSlot& slot = mSlots[mTail % mSlots.size()];
+        size = slot.mSize;
+        std::memcpy(buffer, slot.mData, size);
+        ++mTail;
+        return true;
+    }
+
+private:
+    std::vector<BaselineSlot> mSlots;
+    size_t mHead = 0;
+    size_t mTail = 0;
+    std::mutex mMutex;
+};
+
+// Bounded blocking queue: enqueue waits for space, dequeue waits briefly for data.
+// The wait on dequeue is bounded so consumers can still observe shutdown.
+class CondVarQueue {
+public:
+    explicit CondVarQueue(size_t capacity) : mSlots(capacity) {}
+
+    bool enqueue(const uint8_t* data, size_t size) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mNotFull.wait(lock, [this] { return mHead - mTail < mSlots.size(); });
+
+            BaselineSlot& slot = mSlots[mHead % mSlots.size()];
+            std::memcpy(slot.mData, data, size);
+            slot.mSize = size;
+            ++mHead;
+        }
+        mNotEmpty.notify_one();
+        return true;
+    }
+
+    bool dequeue(uint8_t* buffer, size_t& size) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            if (!mNotEmpty.wait_for(lock, std::chrono::microseconds(100), [this] { return mHead != mTail; })) {
+                return false;
+            }
+
+            BaselineSlot& slot = mSlots[mTail % mSlots.size()];
+            size = slot.mSize;
+            std::memcpy(buffer, slot.mData, size);
+            ++mTail;
+        }
+        mNotFull.notify_one();
+        return true;
+    }
+
+private:
+    std::vector<BaselineSlot> mSlots;
+    size_t mHead = 0;
+    size_t mTail = 0;
+    std::mutex mMutex;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+};
+
+// Bounded ring guarded by a test-and-test-and-set spinlock.
+class SpinlockRingQueue {
+public:
+    explicit SpinlockRingQueue(size_t capacity) : mSlots(capacity) {}
+
+    bool enqueue(const uint8_t* data, size_t size) {
+        lock();
+        if (mHead - mTail == mSlots.size()) {
+            unlock();
+            return false;
+        }
+
+        BaselineSlot& slot = mSlots[mHead % mSlots.size()];
+        std::memcpy(slot.mData, data, size);
+        slot.mSize = size;
+        ++mHead;
+        unlock();
+        return true;
+    }
+
+    bool dequeue(uint8_t* buffer, size_t& size) {
+        lock();
+        if (mHead == mTail) {
+            unlock();
+            return false;
+        }
+
+        BaselineSlot& slot = mSlots[mTail % mSlots.size()];
+        size = slot.mSize;
+        std::memcpy(buffer, slot.mData, size);
+        ++mTail;
+        unlock();
+        return true;
+    }
+
+private:
+    void lock() {
+        while (true) {
+            if (!mLocked.exchange(true, std::memory_order_acquire)) return;
+            while (mLocked.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void unlock() {
+        mLocked.store(false, std::memory_order_release);
+    }
+
+    std::vector<BaselineSlot> mSlots;
+    size_t mHead = 0;
+    size_t mTail = 0;
+    alignas(64) std::atomic<bool> mLocked{false};
+};
+
+// Dmitry Vyukov's bounded MPMC queue: each cell carries a sequence number that tells producers
+// and consumers whether it is free for the current lap, so head and tail only need a CAS each.
+class VyukovMpmcQueue {
+public:
+    explicit VyukovMpmcQueue(size_t capacity) : mCapacity(capacity), mCells(new Cell[capacity]) {
+        for (size_t i = 0; i < capacity; ++i) {
+            mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool enqueue(const uint8_t* data, size_t size) {
+        size_t pos = mHead.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &mCells[pos % mCapacity];
+            size_t seq = cell->mSequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = mHead.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::memcpy(cell->mSlot.mData, data, size);
+        cell->mSlot.mSize = size;
+        cell->mSequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool dequeue(uint8_t* buffer, size_t& size) {
+        size_t pos = mTail.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &mCells[pos % mCapacity];
+            size_t seq = cell->mSequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Empty
+            } else {
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        size = cell->mSlot.mSize;
+        std::memcpy(buffer, cell->mSlot.mData, size);
+        cell->mSequence.store(pos + mCapacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> mSequence;
+        BaselineSlot mSlot;
+    };
+
+    size_t mCapacity;
+    std::unique_ptr<Cell[]> mCells;
+    alignas(64) std::atomic<size_t> mHead{0};
+    alignas(64) std::atomic<size_t> mTail{0};
+};
+
+// Compile-time check that a type satisfies the benchmark queue concept.
+template <typename QueueType, typename = void>
+struct IsBenchmarkQueue : std::false_type {};
+
+template <typename QueueType>
+struct IsBenchmarkQueue<QueueType, std::void_t<
+        decltype(bool(std::declval<QueueType&>().enqueue(std::declval<const uint8_t*>(), size_t{}))),
+        decltype(bool(std::declval<QueueType&>().dequeue(std::declval<uint8_t*>(), std::declval<size_t&>())))>>
+        : std::true_type {};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Counter padded to a full cache line so that per-thread tallies never share a line.
+struct alignas(64) PaddedCounter {
+    std::atomic<uint64_t> mValue{0};
+};
+
+// Pins the calling thread to a CPU (wrapped around the number of online CPUs).
+// Returns:
+// - true if the affinity was applied, false if pinning is unsupported or failed.
+inline bool pinThreadToCpu(unsigned cpu) {
+#ifdef __linux__
+    unsigned cpuCount = std::thread::hardware_concurrency();
+    if (cpuCount == 0) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % cpuCount, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+inline double mean(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    return sum / static_cast<double>(values.size());
+}
+
+// Population standard deviation.
+inline double stddev(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    double m = mean(values);
+    double sum = 0.0;
+    for (double v : values) {
+        sum += (v - m) * (v - m);
+    }
+    return std::sqrt(sum / static_cast<double>(values.size()));
+}
+
+enum class OutputFormat {
+    Text,
+    Csv,
+    Json
+};
+
+inline OutputFormat parseOutputFormat(const std::string& name) {
+    if (name == "csv") return OutputFormat::Csv;
+    if (name == "json") return OutputFormat::Json;
+    return OutputFormat::Text;
+}
+
+// Collects benchmark results as rows of named columns and writes them out as
+// aligned text, CSV or a JSON array of objects, so runs can be plotted and diffed.
+class ResultTable {
+public:
+    explicit ResultTable(std::vector<std::string> columns) : mColumns(std::move(columns)) {}
+
+    void addRow(std::vector<std::string> row) {
+        row.resize(mColumns.size());
+        mRows.push_back(std::move(row));
+    }
+
+    void write(std::ostream& out, OutputFormat format) const {
+        switch (format) {
+            case OutputFormat::Csv: writeCsv(out); break;
+            case OutputFormat::Json: writeJson(out); break;
+            default: writeText(out); break;
+        }
+    }
+
+private:
+    static bool isNumber(const std::string& cell) {
+        if (cell.empty()) return false;
+        char* end = nullptr;
+        std::strtod(cell.c_str(), &end);
+        return end != nullptr && *end == '\0';
+    }
+
+    void writeText(std::ostream& out) const {
+        std::vector<size_t> widths;
+        for (const auto& column : mColumns) {
+            widths.push_back(column.size());
+        }
+        for (const auto& row : mRows) {
+            for (size_t i = 0; i < row.size(); ++i) {
+                widths[i] = std::max(widths[i], row[i].size());
+            }
+        }
+        auto writeLine = [&](const std::vector<std::string>& cells) {
+            for (size_t i = 0; i < cells.size(); ++i) {
+                out << cells[i] << std::string(widths[i] - cells[i].size() + 2, ' ');
+            }
+            out << "\n";
+        };
+        writeLine(mColumns);
+        for (const auto& row : mRows) {
+            writeLine(row);
+        }
+    }
+
+    void writeCsv(std::ostream& out) const {
+        for (size_t i = 0; i < mColumns.size(); ++i) {
+            out << (i ? "," : "") << mColumns[i];
+        }
+        out << "\n";
+        for (const auto& row : mRows) {
+            for (size_t i = 0; i < row.size(); ++i) {
+                out << (i ? "," : "") << row[i];
+            }
+            out << "\n";
+        }
+    }
+
+    void writeJson(std::ostream& out) const {
+        out << "[\n";
+        for (size_t r = 0; r < mRows.size(); ++r) {
+            out << "  {";
+            for (size_t i = 0; i < mColumns.size(); ++i) {
+                const std::string& cell = mRows[r][i];
+                out << (i ? ", " : "") << "\"" << mColumns[i] << "\": ";
+                if (isNumber(cell)) {
+                    out << cell;
+                } else {
+                    out << "\"" << cell << "\"";
+                }
+            }
+            out << "}" << (r + 1 < mRows.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    }
+
+    std::vector<std::string> mColumns;
+    std::vector<std::vector<std::string>> mRows;
+};
+
+#endif
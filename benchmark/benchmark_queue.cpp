@@ -3,44 +3,99 @@
 #include <vector>
 #include <mutex>
 #include <chrono>
-#include <queue>
 #include <cstring>
 #include <atomic>
 #include <memory>
+#include <map>
+#include <optional>
+#include <string>
 #include "../src/spmc_queue.h"
+#include "../src/mpmc_queue.h"
+#include "../src/strided_queue.h"
+#include "../src/spsc_queue.h"
+#include "../src/soa_queue.h"
+#include "baseline_queues.h"
+#include "bench_common.h"
+#include "perf_counters.h"
 
-class MutexQueue {
-public:
-    void enqueue(const uint8_t* data, size_t size) {
-        std::lock_guard<std::mutex> lock(mMutex);
-        std::vector<uint8_t> buffer(data, data + size);
-        mQueue.push(buffer);
+// Layout of a verified 64-byte message: an 8-byte sequence number, 48 payload bytes filled with the
+// producer's value and an 8-byte checksum over everything before it.
+constexpr size_t kVerifiedPayloadOffset = 8;
+constexpr size_t kVerifiedChecksumOffset = 56;
+
+// FNV-1a over the first `size` bytes.
+uint64_t messageChecksum(const uint8_t* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
     }
+    return hash;
+}
 
-    bool dequeue(uint8_t* buffer, size_t& size) {
-        std::lock_guard<std::mutex> lock(mMutex);
-        if (mQueue.empty()) return false;
+void writeVerifiedMessage(uint8_t* data, uint64_t sequence) {
+    std::memcpy(data, &sequence, sizeof(sequence));
+    uint64_t checksum = messageChecksum(data, kVerifiedChecksumOffset);
+    std::memcpy(data + kVerifiedChecksumOffset, &checksum, sizeof(checksum));
+}
 
-        std::vector<uint8_t> front = mQueue.front();
-        mQueue.pop();
-        std::memcpy(buffer, front.data(), front.size());
-        size = front.size();
-        return true;
+// Returns true and the embedded sequence number if the message is intact.
+bool readVerifiedMessage(const uint8_t* data, size_t size, uint64_t& sequence) {
+    if (size != 64) {
+        return false;
+    }
+    uint64_t checksum = 0;
+    std::memcpy(&checksum, data + kVerifiedChecksumOffset, sizeof(checksum));
+    if (checksum != messageChecksum(data, kVerifiedChecksumOffset)) {
+        return false;
     }
+    std::memcpy(&sequence, data, sizeof(sequence));
+    return true;
+}
 
-private:
-    std::queue<std::vector<uint8_t>> mQueue;
-    std::mutex mMutex;
-};
+// Attempts one dequeue and classifies the outcome. Queues without tryDequeue() can only report
+// Success or Empty, so their failed_cas column stays at zero.
+template <typename QueueType>
+DequeueResult attemptDequeue(QueueType& queue, uint8_t* buffer, size_t& size) {
+    return queue.dequeue(buffer, size) ? DequeueResult::Success : DequeueResult::Empty;
+}
 
+inline DequeueResult attemptDequeue(SPMCQueue& queue, uint8_t* buffer, size_t& size) {
+    return queue.tryDequeue(buffer, size);
+}
+
+inline DequeueResult attemptDequeue(MPMCQueue& queue, uint8_t* buffer, size_t& size) {
+    return queue.tryDequeue(buffer, size);
+}
+
+inline DequeueResult attemptDequeue(SoASPMCQueue& queue, uint8_t* buffer, size_t& size) {
+    return queue.tryDequeue(buffer, size);
+}
+
+// Runs numProducers producers and numConsumers consumers against `queue` until every producer has
+// finished and the queue has been drained.
+// With `verify` set, each producer stamps its messages with a global sequence number and checksum,
+// and consumers validate both and record every sequence they receive. The report then lists how many
+// messages were delivered, lost (never received, e.g. overwritten), duplicated and corrupted, and the
+// delivered rate, so a fast result can't hide dropped or torn messages.
 template <typename QueueType>
-void benchmarkQueue(QueueType& queue, int numIterations, int numProducers, int numConsumers, const std::string& queueName) {
-    auto start = std::chrono::high_resolution_clock::now();
+void benchmarkQueue(QueueType& queue, int numIterations, int numProducers, int numConsumers, const std::string& queueName,
+                    bool verify = false) {
+    const uint64_t totalMessages = static_cast<uint64_t>(numIterations) * numProducers;
 
     std::atomic<bool> startFlag{false};
     std::atomic<int> completedProducers{0};
     std::atomic<uint64_t> totalEnqueueSum{0};
-    std::mutex sumMutex;
+    std::atomic<uint64_t> totalDequeueSum{0};
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> duplicated{0};
+    std::atomic<uint64_t> corrupted{0};
+    std::unique_ptr<std::atomic<uint8_t>[]> seen;
+    if (verify) {
+        seen.reset(new std::atomic<uint8_t>[totalMessages]);
+        for (uint64_t i = 0; i < totalMessages; ++i) {
+            seen[i].store(0, std::memory_order_relaxed);
+        }
+    }
 
     auto producer = [&](int id) {
         uint8_t data[64];
@@ -50,7 +105,12 @@ void benchmarkQueue(QueueType& queue, int numIterations, int numProducers, int n
         while (!startFlag) {}
 
         for (int i = 0; i < numIterations; ++i) {
-            queue.enqueue(data, sizeof(data));
+            if (verify) {
+                writeVerifiedMessage(data, static_cast<uint64_t>(id) * numIterations + i);
+            }
+            while (!queue.enqueue(data, sizeof(data))) {
+                std::this_thread::yield();
+            }
             producerSum += (id + 1);
         }
 
@@ -58,21 +118,46 @@ void benchmarkQueue(QueueType& queue, int numIterations, int numProducers, int n
         ++completedProducers;
     };
 
-    auto consumer = [&](size_t maxDataToConsume = 5000000) {
+    auto consumer = [&]() {
         uint8_t buffer[64];
         size_t size = 0;
         uint64_t consumerSum = 0;
-        size_t dataConsumed = 0;
+        uint64_t dataConsumed = 0;
+        uint64_t consumerDuplicated = 0;
+        uint64_t consumerCorrupted = 0;
+
+        while (true) {
+            // Sample completion before dequeueing: if every producer had finished and the queue is
+            // still empty afterwards, nothing is left to read. A Contended attempt (lost CAS, skip past
+            // overwritten blocks, torn copy) says nothing about emptiness, so it is always retried.
+            bool producersDone = completedProducers.load() == numProducers;
+            DequeueResult result = attemptDequeue(queue, buffer, size);
+            if (result != DequeueResult::Success) {
+                if (result == DequeueResult::Empty && producersDone) break;
+                continue;
+            }
 
-        while ((completedProducers.load() < numProducers || queue.dequeue(buffer, size)) && dataConsumed < maxDataToConsume) {
-            if (queue.dequeue(buffer, size)) {
-                ++dataConsumed;
+            ++dataConsumed;
+            if (!verify) {
+                consumerSum += buffer[kVerifiedPayloadOffset];
+                continue;
+            }
 
-                if (dataConsumed >= maxDataToConsume) {
-                    break;
-                }
+            uint64_t sequence = 0;
+            if (!readVerifiedMessage(buffer, size, sequence) || sequence >= totalMessages) {
+                ++consumerCorrupted;
+                continue;
+            }
+            consumerSum += buffer[kVerifiedPayloadOffset];
+            if (seen[sequence].fetch_add(1, std::memory_order_relaxed) != 0) {
+                ++consumerDuplicated;
             }
         }
+
+        totalDequeueSum += consumerSum;
+        received += dataConsumed;
+        duplicated += consumerDuplicated;
+        corrupted += consumerCorrupted;
     };
 
     std::vector<std::thread> producerThreads, consumerThreads;
@@ -85,6 +170,7 @@ void benchmarkQueue(QueueType& queue, int numIterations, int numProducers, int n
         consumerThreads.emplace_back(consumer);
     }
 
+    auto start = std::chrono::high_resolution_clock::now();
     startFlag = true;
 
     for (auto& t : producerThreads) {
@@ -97,23 +183,428 @@ void benchmarkQueue(QueueType& queue, int numIterations, int numProducers, int n
 
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    double seconds = std::chrono::duration<double>(end - start).count();
 
     std::cout << queueName << " benchmark completed in " << duration << " ms\n";
     std::cout << "Total sum of enqueued values: " << totalEnqueueSum.load() << "\n";
+    std::cout << "Total sum of dequeued values: " << totalDequeueSum.load() << "\n";
+
+    if (!verify) {
+        std::cout << "Received " << received.load() << " of " << totalMessages << " messages ("
+                  << static_cast<double>(received.load()) / seconds << " msgs/s)\n";
+        return;
+    }
+
+    uint64_t delivered = 0;
+    for (uint64_t i = 0; i < totalMessages; ++i) {
+        if (seen[i].load(std::memory_order_relaxed) != 0) ++delivered;
+    }
+    std::cout << "Verified: delivered " << delivered << ", lost " << totalMessages - delivered
+              << ", duplicated " << duplicated.load() << ", corrupted " << corrupted.load()
+              << " of " << totalMessages << " messages ("
+              << static_cast<double>(delivered) / seconds << " delivered msgs/s)\n";
+}
+
+// Parses "--key=value" style arguments into a map; bare "--flag" maps to "1".
+// The first positional argument, if any, is returned under the key "mode".
+std::map<std::string, std::string> parseArguments(int argc, char** argv) {
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            args["mode"] = arg;
+            continue;
+        }
+        size_t eq = arg.find('=');
+        if (eq == std::string::npos) {
+            args[arg.substr(2)] = "1";
+        } else {
+            args[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        }
+    }
+    return args;
+}
+
+uint64_t argumentOr(const std::map<std::string, std::string>& args, const std::string& key, uint64_t fallback) {
+    auto it = args.find(key);
+    return it == args.end() ? fallback : std::stoull(it->second);
+}
+
+// Per-consumer tallies for the consumer sweep, each on its own cache line.
+struct alignas(64) ConsumerTally {
+    std::atomic<uint64_t> mConsumed{0};
+    uint64_t mFailedCas = 0;
+    uint64_t mSpuriousEmpty = 0;
+};
+
+// Parameters shared by every workload run.
+struct WorkloadConfig {
+    size_t capacity = 1000;
+    uint64_t messages = 5000000;
+    int consumers = 1;
+    bool pin = true;
+    bool perf = false;          // Capture hardware counters per thread (Linux only)
+    uint64_t hitmRawConfig = 0; // Model-specific raw event used for HITM, 0 to skip it
+    size_t prefetch = 0;        // SPMCQueue prefetch distance in blocks, 0 to disable
+    size_t drain = 0;           // Consume up to this many blocks per call where the queue supports it, 0 for dequeue
+};
+
+// Reads --messages, --capacity, --no-pin, --perf, --perf-hitm-raw, --prefetch and --drain.
+WorkloadConfig workloadConfigFromArguments(const std::map<std::string, std::string>& args) {
+    WorkloadConfig config;
+    config.messages = argumentOr(args, "messages", config.messages);
+    config.capacity = argumentOr(args, "capacity", config.capacity);
+    config.pin = args.count("no-pin") == 0;
+    config.perf = args.count("perf") != 0;
+    config.prefetch = argumentOr(args, "prefetch", config.prefetch);
+    config.drain = argumentOr(args, "drain", config.drain);
+    if (args.count("perf-hitm-raw")) {
+        config.hitmRawConfig = std::stoull(args.at("perf-hitm-raw"), nullptr, 0);
+    }
+    return config;
+}
+
+struct SweepPoint {
+    int consumers = 0;
+    uint64_t messages = 0;
+    double seconds = 0.0;
+    std::vector<uint64_t> consumed;
+    uint64_t failedCas = 0;
+    uint64_t spuriousEmpty = 0;
+    PerfSample producerPerf;
+    PerfSample consumerPerf;
+};
+
+// Adds producer_<event>_per_msg and consumer_<event>_per_msg columns.
+void appendPerfColumns(std::vector<std::string>& columns) {
+    for (const char* side : {"producer", "consumer"}) {
+        for (int event = 0; event < PerfEventCount; ++event) {
+            columns.push_back(std::string(side) + "_" + perfEventName(event) + "_per_msg");
+        }
+    }
+}
+
+void appendPerfCells(std::vector<std::string>& row, const SweepPoint& point) {
+    for (const PerfSample* sample : {&point.producerPerf, &point.consumerPerf}) {
+        for (int event = 0; event < PerfEventCount; ++event) {
+            row.push_back(sample->perMessage(event, point.messages));
+        }
+    }
+}
+
+// Consumes up to `maxCount` blocks in one call. Queues without drain() take one block per call; the
+// SPMCQueue handler copies each block out so the work per message matches dequeue.
+template <typename QueueType>
+size_t attemptDrain(QueueType& queue, size_t, uint8_t* buffer) {
+    size_t size = 0;
+    return attemptDequeue(queue, buffer, size) == DequeueResult::Success ? 1 : 0;
+}
+
+inline size_t attemptDrain(SPMCQueue& queue, size_t maxCount, uint8_t* buffer) {
+    return queue.drain([buffer](const uint8_t* data, size_t size) { std::memcpy(buffer, data, size); }, maxCount);
+}
+
+// Per-consumer view of a queue. Shared queues are used as is; StridedSPMCQueue hands every consumer
+// its own partition.
+template <typename QueueType>
+QueueType& consumerHandle(QueueType& queue, int) {
+    return queue;
+}
+
+inline StridedConsumer consumerHandle(StridedSPMCQueue& queue, int id) {
+    return StridedConsumer(queue, static_cast<size_t>(id));
 }
 
-int main() {
-    const int numIterations = 5000000;
+// Runs one workload: a single producer publishes `messages` blocks to `numConsumers` consumers
+// sharing `queue`. The producer never gets more than `capacity` messages ahead of the consumer group
+// and retries a rejected enqueue, so every queue delivers every message exactly once and the
+// measurement isolates the cost of handing blocks over.
+// Producer runs on CPU 0, consumer i on CPU i + 1 when pinning is enabled. With config.perf each
+// thread counts its own hardware events between the start flag and the end of its loop.
+template <typename QueueType>
+SweepPoint runWorkload(QueueType& queue, const WorkloadConfig& config) {
+    static_assert(IsBenchmarkQueue<QueueType>::value || std::is_same<QueueType, StridedSPMCQueue>::value,
+                  "QueueType must provide enqueue() and dequeue()");
+
+    const size_t capacity = config.capacity;
+    const uint64_t messages = config.messages;
+    const int numConsumers = config.consumers;
+    const bool pin = config.pin;
+    PerfTotals producerPerf;
+    PerfTotals consumerPerf;
+    std::vector<ConsumerTally> tallies(numConsumers);
+    PaddedCounter published;
+    std::atomic<bool> producerDone{false};
+    std::atomic<int> readyThreads{0};
+    std::atomic<bool> startFlag{false};
+
+    auto consumedTotal = [&]() {
+        uint64_t total = 0;
+        for (const auto& tally : tallies) {
+            total += tally.mConsumed.load(std::memory_order_relaxed);
+        }
+        return total;
+    };
+
+    auto producer = [&]() {
+        if (pin) pinThreadToCpu(0);
+        uint8_t data[64];
+        std::memset(data, 0, sizeof(data));
+        uint64_t cachedConsumed = 0;
+        std::optional<PerfCounterGroup> counters;
+        if (config.perf) counters.emplace(config.hitmRawConfig);
+        ++readyThreads;
+        while (!startFlag) {}
+        if (counters) counters->start();
+
+        for (uint64_t i = 0; i < messages; ++i) {
+            // Back-pressure: only re-read the consumer tallies when the cached view says the ring is full.
+            while (i - cachedConsumed >= capacity) {
+                cachedConsumed = consumedTotal();
+                if (i - cachedConsumed >= capacity) std::this_thread::yield();
+            }
+            std::memcpy(data, &i, sizeof(i));
+            while (!queue.enqueue(data, sizeof(data))) {
+                std::this_thread::yield();
+            }
+            published.mValue.store(i + 1, std::memory_order_release);
+        }
+        if (counters) producerPerf.add(counters->stop());
+        producerDone = true;
+    };
+
+    auto consumer = [&](int id) {
+        if (pin) pinThreadToCpu(static_cast<unsigned>(id) + 1);
+        ConsumerTally& tally = tallies[id];
+        auto&& handle = consumerHandle(queue, id);
+        uint8_t buffer[64];
+        size_t size = 0;
+        std::optional<PerfCounterGroup> counters;
+        if (config.perf) counters.emplace(config.hitmRawConfig);
+        ++readyThreads;
+        while (!startFlag) {}
+        if (counters) counters->start();
+
+        while (true) {
+            DequeueResult result;
+            if (config.drain > 0) {
+                size_t drained = attemptDrain(handle, config.drain, buffer);
+                if (drained > 0) {
+                    tally.mConsumed.store(tally.mConsumed.load(std::memory_order_relaxed) + drained,
+                                          std::memory_order_relaxed);
+                    continue;
+                }
+                result = DequeueResult::Empty; // A lost claim is not told apart from an empty ring here
+            } else {
+                result = attemptDequeue(handle, buffer, size);
+            }
+            if (result == DequeueResult::Success) {
+                tally.mConsumed.store(tally.mConsumed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                continue;
+            }
+            if (result == DequeueResult::Contended) {
+                ++tally.mFailedCas;
+                continue;
+            }
+            // Empty: spurious if the producer had published more than the group has consumed.
+            uint64_t total = consumedTotal();
+            if (published.mValue.load(std::memory_order_acquire) > total) {
+                ++tally.mSpuriousEmpty;
+            } else if (producerDone && total >= messages) {
+                break;
+            }
+        }
+        if (counters) consumerPerf.add(counters->stop());
+    };
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(producer);
+    for (int i = 0; i < numConsumers; ++i) {
+        threads.emplace_back(consumer, i);
+    }
+    while (readyThreads.load() < numConsumers + 1) {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    startFlag = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    SweepPoint point;
+    point.consumers = numConsumers;
+    point.messages = messages;
+    point.seconds = std::chrono::duration<double>(end - start).count();
+    for (const auto& tally : tallies) {
+        point.consumed.push_back(tally.mConsumed.load());
+        point.failedCas += tally.mFailedCas;
+        point.spuriousEmpty += tally.mSpuriousEmpty;
+    }
+    point.producerPerf = producerPerf.sample();
+    point.consumerPerf = consumerPerf.sample();
+    return point;
+}
+
+// Sweeps the consumer count from 1 to --max-consumers and reports scaling and contention metrics.
+// Options: --max-consumers=N --messages=M --capacity=C --format=text|csv|json --no-pin
+//          --perf --perf-hitm-raw=0xNNNN --prefetch=K --drain=N
+int runConsumerSweep(const std::map<std::string, std::string>& args) {
+    int maxConsumers = static_cast<int>(argumentOr(args, "max-consumers", 16));
+    WorkloadConfig config = workloadConfigFromArguments(args);
+    uint64_t messages = config.messages;
+    OutputFormat format = parseOutputFormat(args.count("format") ? args.at("format") : "text");
+
+    std::vector<std::string> columns = {"consumers", "messages", "seconds", "msgs_per_sec",
+                                        "msgs_per_sec_per_consumer", "min_consumed", "max_consumed",
+                                        "fairness_stddev", "failed_cas", "failed_cas_per_msg", "spurious_empty"};
+    if (config.perf) appendPerfColumns(columns);
+    ResultTable table(columns);
+
+    for (int consumers = 1; consumers <= maxConsumers; ++consumers) {
+        SPMCQueue queue(config.capacity, StoreMode::Cached, config.prefetch);
+        config.consumers = consumers;
+        SweepPoint point = runWorkload(queue, config);
+
+        std::vector<double> perConsumer(point.consumed.begin(), point.consumed.end());
+        double rate = static_cast<double>(messages) / point.seconds;
+        std::vector<std::string> row = {std::to_string(consumers),
+                      std::to_string(messages),
+                      std::to_string(point.seconds),
+                      std::to_string(rate),
+                      std::to_string(rate / consumers),
+                      std::to_string(*std::min_element(point.consumed.begin(), point.consumed.end())),
+                      std::to_string(*std::max_element(point.consumed.begin(), point.consumed.end())),
+                      std::to_string(stddev(perConsumer)),
+                      std::to_string(point.failedCas),
+                      std::to_string(static_cast<double>(point.failedCas) / messages),
+                      std::to_string(point.spuriousEmpty)};
+        if (config.perf) appendPerfCells(row, point);
+        table.addRow(row);
+    }
+
+    table.write(std::cout, format);
+    return 0;
+}
+
+// Splits a comma-separated list such as "1,2,4" into its fields.
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        if (comma > start) fields.push_back(list.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return fields;
+}
+
+// Runs the same workloads against SPMCQueue and every baseline queue.
+// Options: --consumers=1,2,4 --queues=spmc,spmc_nt,spmc_soa,spsc,mpmc,strided,mutex_ring,condvar,spinlock_ring,vyukov_mpmc
+//          --messages=M --capacity=C --format=text|csv|json --no-pin --perf --perf-hitm-raw=0xNNNN
+//          --prefetch=K --drain=N
+int runQueueComparison(const std::map<std::string, std::string>& args) {
+    WorkloadConfig config = workloadConfigFromArguments(args);
+    uint64_t messages = config.messages;
+    size_t capacity = config.capacity;
+    OutputFormat format = parseOutputFormat(args.count("format") ? args.at("format") : "text");
+    std::vector<std::string> consumerCounts = splitList(args.count("consumers") ? args.at("consumers") : "1,2,4");
+    std::vector<std::string> queueNames = splitList(args.count("queues") ? args.at("queues")
+                                                    : "spmc,spsc,mpmc,strided,mutex_ring,condvar,spinlock_ring,vyukov_mpmc");
+
+    std::vector<std::string> columns = {"queue", "consumers", "messages", "seconds", "msgs_per_sec",
+                                        "fairness_stddev", "failed_cas", "spurious_empty"};
+    if (config.perf) appendPerfColumns(columns);
+    ResultTable table(columns);
+
+    auto runCase = [&](const std::string& name, int consumers, auto& queue) {
+        config.consumers = consumers;
+        SweepPoint point = runWorkload(queue, config);
+        std::vector<double> perConsumer(point.consumed.begin(), point.consumed.end());
+        std::vector<std::string> row = {name,
+                      std::to_string(consumers),
+                      std::to_string(messages),
+                      std::to_string(point.seconds),
+                      std::to_string(static_cast<double>(messages) / point.seconds),
+                      std::to_string(stddev(perConsumer)),
+                      std::to_string(point.failedCas),
+                      std::to_string(point.spuriousEmpty)};
+        if (config.perf) appendPerfCells(row, point);
+        table.addRow(row);
+    };
+
+    for (const auto& count : consumerCounts) {
+        int consumers = std::stoi(count);
+        for (const auto& name : queueNames) {
+            if (name == "spmc") {
+                SPMCQueue queue(capacity, StoreMode::Cached, config.prefetch);
+                runCase(name, consumers, queue);
+            } else if (name == "spmc_nt") {
+                SPMCQueue queue(capacity, StoreMode::NonTemporal, config.prefetch);
+                runCase(name, consumers, queue);
+            } else if (name == "spmc_soa") {
+                SoASPMCQueue queue(capacity);
+                runCase(name, consumers, queue);
+            } else if (name == "spsc") {
+                if (consumers != 1) continue; // Only defined for a single consumer
+                SPSCQueue queue(capacity);
+                runCase(name, consumers, queue);
+            } else if (name == "mpmc") {
+                MPMCQueue queue(capacity);
+                runCase(name, consumers, queue);
+            } else if (name == "strided") {
+                // Rounded down to a multiple of the consumer count, as the partitioning requires
+                size_t perConsumer = capacity / consumers > 0 ? capacity / consumers : 1;
+                StridedSPMCQueue queue(perConsumer * consumers, consumers);
+                runCase(name, consumers, queue);
+            } else if (name == "mutex_ring") {
+                MutexRingQueue queue(capacity);
+                runCase(name, consumers, queue);
+            } else if (name == "condvar") {
+                CondVarQueue queue(capacity);
+                runCase(name, consumers, queue);
+            } else if (name == "spinlock_ring") {
+                SpinlockRingQueue queue(capacity);
+                runCase(name, consumers, queue);
+            } else if (name == "vyukov_mpmc") {
+                VyukovMpmcQueue queue(capacity);
+                runCase(name, consumers, queue);
+            } else {
+                std::cerr << "Unknown queue: " << name << "\n";
+                return 1;
+            }
+        }
+    }
+
+    table.write(std::cout, format);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    auto args = parseArguments(argc, argv);
+    if (args.count("mode") && args["mode"] == "sweep") {
+        return runConsumerSweep(args);
+    }
+    if (args.count("mode") && args["mode"] == "compare") {
+        return runQueueComparison(args);
+    }
+
+    // Default mode: --messages=M --consumers=N --capacity=C --prefetch=K --verify
+    const int numIterations = static_cast<int>(argumentOr(args, "messages", 5000000));
     const int numProducers = 1;
-    const int numConsumers = 2;
+    const int numConsumers = static_cast<int>(argumentOr(args, "consumers", 2));
+    const size_t capacity = argumentOr(args, "capacity", 1000);
+    const bool verify = args.count("verify") != 0;
 
     // Benchmark SPMCQueue
-    SPMCQueue spmcQueue(1000);
-    benchmarkQueue(spmcQueue, numIterations, numProducers, numConsumers, "SPMCQueue");
+    SPMCQueue spmcQueue(capacity, StoreMode::Cached, argumentOr(args, "prefetch", 0));
+    benchmarkQueue(spmcQueue, numIterations, numProducers, numConsumers, "SPMCQueue", verify);
 
-    // Benchmark MutexQueue
-    MutexQueue mutexQueue;
-    benchmarkQueue(mutexQueue, numIterations, numProducers, numConsumers, "MutexQueue");
+    // Benchmark MutexRingQueue
+    MutexRingQueue mutexQueue(capacity);
+    benchmarkQueue(mutexQueue, numIterations, numProducers, numConsumers, "MutexRingQueue", verify);
 
     return 0;
 }
@@ -0,0 +1,158 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware events captured per thread by PerfCounterGroup.
+enum PerfEvent {
+    PerfCycles,
+    PerfInstructions,
+    PerfL1dMisses,
+    PerfLlcMisses,
+    PerfHitm,
+    PerfEventCount
+};
+
+inline const char* perfEventName(int event) {
+    static const char* names[PerfEventCount] = {"cycles", "instructions", "l1d_misses", "llc_misses", "hitm"};
+    return names[event];
+}
+
+// Counter values for one thread or summed over several. An event is only valid if every
+// contributing thread managed to open and read it.
+struct PerfSample {
+    uint64_t mValues[PerfEventCount] = {};
+    bool mValid[PerfEventCount] = {};
+    int mThreads = 0;
+
+    void add(const PerfSample& other) {
+        for (int i = 0; i < PerfEventCount; ++i) {
+            mValid[i] = (mThreads == 0 ? other.mValid[i] : mValid[i] && other.mValid[i]);
+            mValues[i] += other.mValues[i];
+        }
+        mThreads += other.mThreads;
+    }
+
+    // Events per message, or "n/a" if the event could not be collected.
+    std::string perMessage(int event, uint64_t messages) const {
+        if (mThreads == 0 || !mValid[event] || messages == 0) {
+            return "n/a";
+        }
+        return std::to_string(static_cast<double>(mValues[event]) / static_cast<double>(messages));
+    }
+};
+
+// Thread-safe accumulator used by worker threads to publish their samples at the end of a case.
+class PerfTotals {
+public:
+    void add(const PerfSample& sample) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSample.add(sample);
+    }
+
+    PerfSample sample() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSample;
+    }
+
+private:
+    mutable std::mutex mMutex;
+    PerfSample mSample;
+};
+
+// Opens the hardware counters for the calling thread through perf_event_open.
+// Each event is opened on its own, so an event the CPU or kernel does not support (or a
+// restrictive perf_event_paranoid setting) only drops that event instead of the whole group.
+// HITM has no generic encoding; pass the model-specific raw config (e.g. 0x04d2 for
+// MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM on Skylake) or 0 to skip it.
+class PerfCounterGroup {
+public:
+    explicit PerfCounterGroup(uint64_t hitmRawConfig = 0) {
+        for (int i = 0; i < PerfEventCount; ++i) {
+            mFds[i] = -1;
+        }
+#ifdef __linux__
+        const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D
+                                     | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                     | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        mFds[PerfCycles] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        mFds[PerfInstructions] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        mFds[PerfL1dMisses] = openEvent(PERF_TYPE_HW_CACHE, l1dReadMiss);
+        mFds[PerfLlcMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        if (hitmRawConfig != 0) {
+            mFds[PerfHitm] = openEvent(PERF_TYPE_RAW, hitmRawConfig);
+        }
+#else
+        (void)hitmRawConfig;
+#endif
+    }
+
+    ~PerfCounterGroup() {
+#ifdef __linux__
+        for (int fd : mFds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    // Resets and enables every open counter.
+    void start() {
+#ifdef __linux__
+        for (int fd : mFds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Disables the counters and returns their values for this thread.
+    PerfSample stop() {
+        PerfSample sample;
+        sample.mThreads = 1;
+#ifdef __linux__
+        for (int i = 0; i < PerfEventCount; ++i) {
+            if (mFds[i] < 0) continue;
+            ioctl(mFds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t value = 0;
+            if (read(mFds[i], &value, sizeof(value)) == sizeof(value)) {
+                sample.mValues[i] = value;
+                sample.mValid[i] = true;
+            }
+        }
+#endif
+        return sample;
+    }
+
+private:
+#ifdef __linux__
+    static int openEvent(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    int mFds[PerfEventCount];
+};
+
+#endif
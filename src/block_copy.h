@@ -0,0 +1,96 @@
+#ifndef BLOCK_COPY_H
+#define BLOCK_COPY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Payload copies between caller buffers and a block's 64-byte-aligned mData.
+//
+// Full 64-byte payloads, the common case, take a fixed-size kernel: one AVX-512 load/store pair, two AVX2
+// pairs or four SSE2 pairs, whichever the compiler targets (configure with SPMC_ENABLE_NATIVE to build for
+// the host CPU). The block side uses aligned accesses and the caller side unaligned ones. The kernel is
+// picked at compile time rather than by CPU dispatch, since an indirect call would cost more than the copy.
+// Other sizes go through std::memcpy.
+//
+// streamToBlock() writes with non-temporal stores, which bypass the producer's cache. They are weakly ordered,
+// so the producer must call streamFence() before publishing the block.
+
+constexpr size_t kBlockPayloadSize = 64;
+
+inline void copyToBlock(uint8_t* block, const uint8_t* data, size_t size) {
+    if (size != kBlockPayloadSize) {
+        std::memcpy(block, data, size);
+        return;
+    }
+#if defined(__AVX512F__)
+    _mm512_store_si512(block, _mm512_loadu_si512(data));
+#elif defined(__AVX2__)
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block), low);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(block + 32), high);
+#elif defined(__SSE2__)
+    for (size_t offset = 0; offset < kBlockPayloadSize; offset += 16) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(block + offset),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)));
+    }
+#else
+    std::memcpy(block, data, kBlockPayloadSize);
+#endif
+}
+
+inline void copyFromBlock(uint8_t* buffer, const uint8_t* block, size_t size) {
+    if (size != kBlockPayloadSize) {
+        std::memcpy(buffer, block, size);
+        return;
+    }
+#if defined(__AVX512F__)
+    _mm512_storeu_si512(buffer, _mm512_load_si512(block));
+#elif defined(__AVX2__)
+    __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(block + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + 32), high);
+#elif defined(__SSE2__)
+    for (size_t offset = 0; offset < kBlockPayloadSize; offset += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + offset),
+                         _mm_load_si128(reinterpret_cast<const __m128i*>(block + offset)));
+    }
+#else
+    std::memcpy(buffer, block, kBlockPayloadSize);
+#endif
+}
+
+// Non-temporal variant of copyToBlock. Streams whole 16-byte chunks and writes any remainder normally.
+inline void streamToBlock(uint8_t* block, const uint8_t* data, size_t size) {
+#if defined(__AVX512F__)
+    if (size == kBlockPayloadSize) {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(block), _mm512_loadu_si512(data));
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(block + offset),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)));
+    }
+    std::memcpy(block + offset, data + offset, size - offset);
+#else
+    std::memcpy(block, data, size);
+#endif
+}
+
+// Orders earlier non-temporal stores before any later store.
+inline void streamFence() {
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include "conflating_queue.h"
+#include <cstring>
+#include <thread>
+#include "block_copy.h"
+#include "key_hash.h"
+
+namespace {
+
+size_t tableSizeFor(size_t maxKeys) {
+    size_t size = 1;
+    while (size < 2 * maxKeys) {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // namespace
+
+// Constructor for ConflatingQueue.
+// Sizes the key table at twice maxKeys (rounded up to a power of two) to keep probe sequences short, and the
+// dirty-key queue at one block per table slot so that it can never overrun.
+ConflatingQueue::ConflatingQueue(size_t maxKeys)
+        : mMaxKeys(maxKeys), mTableMask(tableSizeFor(maxKeys) - 1), mSlots(new KeySlot[mTableMask + 1]),
+          mDirty(mTableMask + 1), mKeys(new uint64_t[mTableMask + 1]()), mUsed(new bool[mTableMask + 1]()),
+          mKeyCount(0) {
+}
+
+// Enqueue function: Publishes the latest value of a key.
+// Parameters:
+// - key: key the value belongs to, e.g. an instrument id.
+// - data: pointer to the value.
+// - size: size of the value (at most 64 bytes).
+// Returns:
+// - true if the value was stored, false if the key table is full.
+bool ConflatingQueue::enqueue(uint64_t key, const uint8_t* data, size_t size) {
+    size_t index;
+    if (!slotFor(key, index)) {
+        return false;
+    }
+    KeySlot& slot = mSlots[index];
+
+    uint64_t version = slot.mVersion.load(std::memory_order_relaxed);
+    slot.mVersion.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    copyToBlock(slot.mData, data, size);
+    slot.mSize.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    slot.mVersion.store(version + 2, std::memory_order_release);
+
+    // Queue the key unless it is already waiting for a consumer, which will then read this value
+    if (slot.mPending.exchange(1, std::memory_order_acq_rel) == 0) {
+        uint32_t queued = static_cast<uint32_t>(index);
+        mDirty.enqueue(reinterpret_cast<const uint8_t*>(&queued), sizeof(queued));
+    }
+    return true;
+}
+
+// Dequeue function: Reads the latest value of the next pending key.
+// Parameters:
+// - key: receives the key.
+// - buffer: receives the value (64 bytes).
+// - size: receives the size of the value.
+// Returns:
+// - true if a value was copied, false if no key is pending.
+bool ConflatingQueue::dequeue(uint64_t& key, uint8_t* buffer, size_t& size) {
+    uint8_t entry[64];
+    size_t entrySize = 0;
+    DequeueResult result;
+    while ((result = mDirty.tryDequeue(entry, entrySize)) == DequeueResult::Contended) {
+    }
+    if (result == DequeueResult::Empty) {
+        return false;
+    }
+    uint32_t index;
+    std::memcpy(&index, entry, sizeof(index));
+    KeySlot& slot = mSlots[index];
+
+    // Clear the mark before reading: an update that lands after this either shows up in the copy below or
+    // queues the key again
+    slot.mPending.exchange(0, std::memory_order_acq_rel);
+
+    while (true) {
+        uint64_t version = slot.mVersion.load(std::memory_order_acquire);
+        if (version % 2 == 1) {
+            std::this_thread::yield(); // The producer is writing this value
+            continue;
+        }
+        size = slot.mSize.load(std::memory_order_relaxed);
+        copyFromBlock(buffer, slot.mData, size);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.mVersion.load(std::memory_order_relaxed) == version) {
+            break;
+        }
+    }
+    key = slot.mKey.load(std::memory_order_relaxed);
+    return true;
+}
+
+size_t ConflatingQueue::pending() const {
+    return mDirty.depth();
+}
+
+size_t ConflatingQueue::keyCount() const {
+    return mKeyCount.load(std::memory_order_relaxed);
+}
+
+// SlotFor function: Finds the slot of a key by linear probing, claiming a free one for a new key.
+// Returns:
+// - false if the key is new and maxKeys keys are already in use.
+bool ConflatingQueue::slotFor(uint64_t key, size_t& index) {
+    index = mixKey(key) & mTableMask;
+    while (mUsed[index]) {
+        if (mKeys[index] == key) {
+            return true;
+        }
+        index = (index + 1) & mTableMask;
+    }
+
+    size_t count = mKeyCount.load(std::memory_order_relaxed);
+    if (count == mMaxKeys) {
+        return false;
+    }
+    mUsed[index] = true;
+    mKeys[index] = key;
+    mSlots[index].mKey.store(key, std::memory_order_relaxed);
+    mKeyCount.store(count + 1, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef CONFLATING_QUEUE_H
+#define CONFLATING_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "spmc_queue.h"
+
+// Conflating last-value queue for consumers that only need the latest update per key, such as price
+// displays. A consumer that falls behind reads each key once, with its newest value, instead of every
+// intermediate update, so its work is bounded by the number of keys however bursty the producer is.
+//
+// Each key owns a slot in a fixed table holding its latest value under a seqlock. The first update after a
+// key was last read marks the slot pending and publishes the slot's index on a dirty-key SPMCQueue; later
+// updates only overwrite the value. A consumer takes an index off that queue, clears the pending mark and
+// copies the value. A key is on the dirty queue at most once, so a queue with one block per key never
+// overruns, and the last value of every key is always delivered.
+//
+// Clearing and setting the pending mark are exchanges on both sides, so the producer pays one locked
+// instruction per update; it is what guarantees that an update racing with a consumer's read is either
+// seen by that read or queued again. Consumers share the dirty queue like SPMCQueue consumers: each
+// update is delivered to one of them. Use one ConflatingQueue per consumer to broadcast.
+class ConflatingQueue {
+public:
+    // Parameters:
+    // - maxKeys: number of distinct keys the queue can hold; enqueue refuses new keys beyond it.
+    explicit ConflatingQueue(size_t maxKeys);
+
+    ConflatingQueue(const ConflatingQueue&) = delete;
+    ConflatingQueue& operator=(const ConflatingQueue&) = delete;
+
+    // Replaces the latest value of `key`. Producer thread only.
+    // Returns false if `key` is new and maxKeys keys are already in use.
+    bool enqueue(uint64_t key, const uint8_t* data, size_t size);
+
+    // Copies the latest value of a key updated since it was last read.
+    // Returns false if no key is pending.
+    bool dequeue(uint64_t& key, uint8_t* buffer, size_t& size);
+
+    // Number of keys with an update not yet read.
+    size_t pending() const;
+
+    // Number of distinct keys seen so far.
+    size_t keyCount() const;
+
+private:
+    struct alignas(64) KeySlot {
+        std::atomic<uint64_t> mKey{0};     // written once, before the slot is first queued
+        std::atomic<uint64_t> mVersion{0}; // seqlock: odd while the producer writes the value
+        std::atomic<uint32_t> mSize{0};
+        std::atomic<uint32_t> mPending{0}; // 1 while the slot's index is on the dirty queue
+        alignas(64) uint8_t mData[64];
+    };
+
+    bool slotFor(uint64_t key, size_t& index);
+
+    size_t mMaxKeys;
+    size_t mTableMask;                     // open-addressing table size - 1, a power of two
+    std::unique_ptr<KeySlot[]> mSlots;     // indexed like the table
+    SPMCQueue mDirty;                      // slot indices with an unread update
+
+    // Producer-owned lookup table
+    std::unique_ptr<uint64_t[]> mKeys;
+    std::unique_ptr<bool[]> mUsed;
+    std::atomic<size_t> mKeyCount;
+};
+
+#endif
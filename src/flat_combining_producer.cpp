@@ -0,0 +1,77 @@
+#include "flat_combining_producer.h"
+#include <thread>
+
+// Constructor for FlatCombiningProducer.
+// Parameters:
+// - queue: queue that all publishers feed; only the combiner calls its enqueue.
+FlatCombiningProducer::FlatCombiningProducer(SPMCQueue& queue)
+        : mQueue(queue), mCombinerLock(false), mSlotsInUse(0) {
+}
+
+// Publish function: Posts the request in the calling thread's slot and waits until it is enqueued,
+// becoming the combiner whenever the role is free.
+// Parameters:
+// - data: pointer to the data to be enqueued; must stay valid until publish returns.
+// - size: size of the data to be enqueued.
+// Returns:
+// - the result of the underlying enqueue.
+bool FlatCombiningProducer::publish(const uint8_t* data, size_t size) {
+    size_t index = threadSlotIndex();
+
+    // Threads without a private slot can't post safely; they take the combiner role and enqueue directly
+    if (index == kSharedThreadSlot) {
+        while (!tryLock()) {
+            std::this_thread::yield();
+        }
+        bool result = mQueue.enqueue(data, size);
+        combine();
+        unlock();
+        return result;
+    }
+
+    size_t inUse = mSlotsInUse.load(std::memory_order_relaxed);
+    while (inUse <= index && !mSlotsInUse.compare_exchange_weak(inUse, index + 1, std::memory_order_relaxed)) {
+    }
+
+    PublishSlot& slot = mSlots[index];
+    slot.mData = data;
+    slot.mSize = size;
+    slot.mState.store(Pending, std::memory_order_release);
+
+    while (true) {
+        if (slot.mState.load(std::memory_order_acquire) == Done) {
+            break;
+        }
+        if (tryLock()) {
+            combine(); // Serves our own request along with everyone else's
+            unlock();
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    slot.mState.store(Idle, std::memory_order_relaxed);
+    return slot.mResult;
+}
+
+// Test-and-test-and-set acquisition of the combiner role.
+bool FlatCombiningProducer::tryLock() {
+    return !mCombinerLock.load(std::memory_order_relaxed) && !mCombinerLock.exchange(true, std::memory_order_acquire);
+}
+
+void FlatCombiningProducer::unlock() {
+    mCombinerLock.store(false, std::memory_order_release);
+}
+
+// Combine function: Drains every pending slot into the queue. Must hold the combiner role.
+void FlatCombiningProducer::combine() {
+    size_t inUse = mSlotsInUse.load(std::memory_order_acquire);
+    for (size_t i = 0; i < inUse; ++i) {
+        PublishSlot& slot = mSlots[i];
+        if (slot.mState.load(std::memory_order_acquire) != Pending) {
+            continue;
+        }
+        slot.mResult = mQueue.enqueue(slot.mData, slot.mSize);
+        slot.mState.store(Done, std::memory_order_release);
+    }
+}
@@ -0,0 +1,556 @@
+#include "journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "block_copy.h"
+
+namespace {
+
+std::runtime_error journalError(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+size_t segmentBytes(size_t slotsPerSegment) {
+    return kJournalHeaderSize + slotsPerSegment * sizeof(Block);
+}
+
+std::string segmentPath(const std::string& directory, uint64_t segment) {
+    return directory + "/" + journalSegmentName(segment);
+}
+
+// Maps an existing segment file and validates its header. Returns an unmapped segment if the file is
+// missing, still being created or not a journal segment.
+JournalSegment mapExistingSegment(const std::string& directory, uint64_t segment, bool writable) {
+    JournalSegment mapped;
+    int fd = open(segmentPath(directory, segment).c_str(), writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        return mapped;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < kJournalHeaderSize) {
+        close(fd);
+        return mapped;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* memory = mmap(nullptr, bytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return mapped;
+    }
+
+    const JournalSegmentHeader* header = static_cast<const JournalSegmentHeader*>(memory);
+    if (header->mMagic != kJournalMagic || header->mVersion != kJournalVersion || header->mSegment != segment
+        || bytes < segmentBytes(header->mSlotsPerSegment)) {
+        munmap(memory, bytes);
+        return mapped;
+    }
+    mapped.mIndex = segment;
+    mapped.mMemory = memory;
+    mapped.mBytes = bytes;
+    return mapped;
+}
+
+// Synchronously writes a mapped segment's first `bytes` bytes to disk. Returns an error message, empty on success.
+std::string flushSegment(const std::string& directory, const JournalSegment& segment, size_t bytes) {
+    if (segment.mMemory == nullptr || msync(segment.mMemory, bytes, MS_SYNC) == 0) {
+        return std::string();
+    }
+    return journalError("msync", segmentPath(directory, segment.mIndex)).what();
+}
+
+// Whether a segment file was left unfinished by a writer that crashed inside createSegment: too short for a
+// header, or still without its magic, which is written last.
+bool isUnfinishedSegment(const std::string& directory, uint64_t segment) {
+    int fd = open(segmentPath(directory, segment).c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    JournalSegmentHeader header;
+    ssize_t bytes = pread(fd, &header, sizeof(header), 0);
+    close(fd);
+    return bytes >= 0 && (static_cast<size_t>(bytes) < sizeof(header) || header.mMagic == 0);
+}
+
+void unmapSegment(JournalSegment& segment) {
+    if (segment.mMemory != nullptr) {
+        munmap(segment.mMemory, segment.mBytes);
+        segment.mMemory = nullptr;
+    }
+}
+
+} // namespace
+
+std::string journalSegmentName(uint64_t segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 ".seg", segment);
+    return name;
+}
+
+bool parseJournalSegmentName(const std::string& name, uint64_t& segment) {
+    if (name.size() != 20 || name.compare(16, 4, ".seg") != 0) {
+        return false;
+    }
+    segment = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        char c = name[i];
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint64_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint64_t>(c - 'a' + 10);
+        } else {
+            return false;
+        }
+        segment = segment << 4 | digit;
+    }
+    return true;
+}
+
+std::vector<uint64_t> listJournalSegments(const std::string& directory) {
+    std::vector<uint64_t> segments;
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return segments;
+    }
+    while (dirent* entry = readdir(dir)) {
+        uint64_t segment;
+        if (parseJournalSegmentName(entry->d_name, segment)) {
+            segments.push_back(segment);
+        }
+    }
+    closedir(dir);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// Constructor for JournalWriter.
+// Parameters:
+// - directory: directory holding the segment files.
+// - slotsPerSegment: number of records per segment file, ignored when continuing an existing journal.
+// - retainedSegments: number of segment files kept on disk, 0 for all.
+JournalWriter::JournalWriter(const std::string& directory, size_t slotsPerSegment, size_t retainedSegments)
+        : mDirectory(directory), mSlotsPerSegment(slotsPerSegment), mRetainedSegments(retainedSegments),
+          mRecords(nullptr), mNext(0), mSegmentEnd(0), mActive(0), mFlushedEnd(0), mStopping(false) {
+    if (mkdir(mDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw journalError("mkdir", mDirectory);
+    }
+
+    // Continue after the last record of the newest segment. A newest segment without records was only
+    // prepared ahead of time, so the one before it may not be full yet; the same goes for one the previous
+    // writer crashed while creating.
+    std::vector<uint64_t> segments = listJournalSegments(mDirectory);
+    while (!segments.empty()) {
+        mCurrent = mapExistingSegment(mDirectory, segments.back(), true);
+        if (mCurrent.mMemory == nullptr && isUnfinishedSegment(mDirectory, segments.back())) {
+            unlink(segmentPath(mDirectory, segments.back()).c_str());
+            segments.pop_back();
+            continue;
+        }
+        if (mCurrent.mMemory == nullptr) {
+            throw std::runtime_error(segmentPath(mDirectory, segments.back()) + " is not a compatible journal segment");
+        }
+        mSlotsPerSegment = static_cast<const JournalSegmentHeader*>(mCurrent.mMemory)->mSlotsPerSegment;
+        mRecords = mCurrent.records();
+        size_t written = 0;
+        while (written < mSlotsPerSegment && mRecords[written].mHeader.load(std::memory_order_relaxed) != 0) {
+            ++written;
+        }
+        if (written == 0 && segments.size() > 1) {
+            unmapSegment(mCurrent);
+            unlink(segmentPath(mDirectory, segments.back()).c_str());
+            segments.pop_back();
+            continue;
+        }
+        mNext = mCurrent.mIndex * mSlotsPerSegment + written;
+        break;
+    }
+    if (segments.empty()) {
+        mCurrent = createSegment(0);
+        mRecords = mCurrent.records();
+    }
+    mActive = mCurrent.mIndex;
+    mFlushedEnd = mCurrent.mIndex;
+    mSegmentEnd = (mCurrent.mIndex + 1) * mSlotsPerSegment;
+
+    mMaintenance = std::thread(&JournalWriter::maintain, this);
+}
+
+// Destructor for JournalWriter.
+// Stops the maintenance thread, flushes the segments still mapped and unmaps them. The files stay on disk for
+// readers and replay.
+JournalWriter::~JournalWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_one();
+    mMaintenance.join();
+
+    for (JournalSegment& segment : mRetired) {
+        flushSegment(mDirectory, segment, segment.mBytes);
+        unmapSegment(segment);
+    }
+    flushSegment(mDirectory, mCurrent, writtenBytes());
+    unmapSegment(mCurrent);
+    unmapSegment(mPrepared);
+}
+
+// Append function: Copies a message into the next record of the current segment.
+// Parameters:
+// - data: pointer to the data to be appended.
+// - size: size of the data to be appended (at most 64 bytes).
+// Returns:
+// - the message's sequence number.
+// Throws std::runtime_error if the journal needs a new segment and it cannot be created.
+uint64_t JournalWriter::append(const uint8_t* data, size_t size) {
+    return append(data, size, 0);
+}
+
+// Append function: Appends a message stamped with its publish time.
+// Parameters:
+// - data: pointer to the data to be appended.
+// - size: size of the data to be appended (at most 64 bytes).
+// - timestampNs: publish time in nanoseconds on the writer's clock, not lower than the previous record's.
+// Returns:
+// - the message's sequence number.
+uint64_t JournalWriter::append(const uint8_t* data, size_t size, uint64_t timestampNs) {
+    uint64_t sequence = mNext;
+    if (sequence == mSegmentEnd) {
+        roll();
+    }
+
+    Block& record = mRecords[sequence - (mSegmentEnd - mSlotsPerSegment)];
+    copyToBlock(record.mData, data, size);
+    record.mTimestampNs.store(timestampNs, std::memory_order_relaxed);
+    record.mHeader.store(packBlockHeader(sequence + 1, size), std::memory_order_release);
+
+    mNext = sequence + 1;
+    return sequence;
+}
+
+uint64_t JournalWriter::nextSequence() const {
+    return mNext;
+}
+
+size_t JournalWriter::slotsPerSegment() const {
+    return mSlotsPerSegment;
+}
+
+// Flush function: Synchronously writes every record appended so far to disk. The current segment is msynced
+// here; finished segments are flushed by the maintenance thread when the writer rolls past them, and this
+// waits for it to catch up. Called from the producer thread.
+// Throws std::runtime_error if a flush failed.
+void JournalWriter::flush() {
+    std::string error = flushSegment(mDirectory, mCurrent, writtenBytes());
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReady.wait(lock, [this] { return mFlushedEnd >= mCurrent.mIndex || !mFlushError.empty(); });
+    if (error.empty()) {
+        error.swap(mFlushError);
+    }
+    mFlushError.clear();
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+// WrittenBytes function: Length of the current segment's mapping up to and including its last record.
+size_t JournalWriter::writtenBytes() const {
+    return kJournalHeaderSize + static_cast<size_t>(mNext - mCurrent.mIndex * mSlotsPerSegment) * sizeof(Block);
+}
+
+// Roll function: Switches to the segment the maintenance thread prepared, waiting for it only if the
+// producer outran the file system, and hands the finished segment back to be unmapped.
+void JournalWriter::roll() {
+    uint64_t segment = mCurrent.mIndex + 1;
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReady.wait(lock, [this] { return mPrepared.mMemory != nullptr || !mError.empty(); });
+    if (mPrepared.mMemory == nullptr) {
+        std::string error = mError;
+        mError.clear(); // Let the maintenance thread try again on the next append
+        lock.unlock();
+        mWake.notify_one();
+        throw std::runtime_error(error);
+    }
+
+    mRetired.push_back(mCurrent);
+    mCurrent = mPrepared;
+    mPrepared = JournalSegment();
+    mActive = segment;
+    lock.unlock();
+    mWake.notify_one();
+
+    mRecords = mCurrent.records();
+    mSegmentEnd = (segment + 1) * mSlotsPerSegment;
+}
+
+// CreateSegment function: Creates, sizes and maps a segment file. The file's blocks are allocated up front
+// and every page of the mapping is written once, so the producer takes neither a page fault nor a block
+// allocation on its hot path (MAP_POPULATE alone would leave shared pages read-only until the first store).
+// The header's magic is written last, so a reader never accepts a half-initialised file.
+JournalSegment JournalWriter::createSegment(uint64_t segment) const {
+    std::string path = segmentPath(mDirectory, segment);
+    int fd = open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw journalError("open", path);
+    }
+    size_t bytes = segmentBytes(mSlotsPerSegment);
+    int result = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+    if (result != 0) {
+        close(fd);
+        unlink(path.c_str());
+        errno = result; // posix_fallocate returns the error instead of setting errno
+        throw journalError("posix_fallocate", path);
+    }
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        unlink(path.c_str());
+        throw journalError("mmap", path);
+    }
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < bytes; offset += pageSize) {
+        static_cast<volatile uint8_t*>(memory)[offset] = 0;
+    }
+
+    JournalSegmentHeader* header = static_cast<JournalSegmentHeader*>(memory);
+    header->mVersion = kJournalVersion;
+    header->mSlotsPerSegment = mSlotsPerSegment;
+    header->mSegment = segment;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->mMagic = kJournalMagic;
+
+    JournalSegment created;
+    created.mIndex = segment;
+    created.mMemory = memory;
+    created.mBytes = bytes;
+    return created;
+}
+
+// Maintain function: Body of the maintenance thread. Whenever the writer rolls it flushes and unmaps the
+// finished segments, deletes the files beyond the retention limit and prepares the segment after the active one.
+// Only this thread creates segments once the writer is running.
+void JournalWriter::maintain() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping) {
+        std::vector<JournalSegment> retired;
+        retired.swap(mRetired);
+        uint64_t active = mActive;
+        bool prepare = mPrepared.mMemory == nullptr && mError.empty();
+        lock.unlock();
+
+        std::string flushError;
+        for (JournalSegment& segment : retired) {
+            std::string error = flushSegment(mDirectory, segment, segment.mBytes);
+            if (flushError.empty()) {
+                flushError = error;
+            }
+            unmapSegment(segment);
+        }
+        if (mRetainedSegments != 0) {
+            for (uint64_t segment : listJournalSegments(mDirectory)) {
+                if (segment + mRetainedSegments > active) {
+                    break;
+                }
+                unlink(segmentPath(mDirectory, segment).c_str());
+            }
+        }
+        JournalSegment prepared;
+        std::string error;
+        if (prepare) {
+            try {
+                prepared = createSegment(active + 1);
+            } catch (const std::runtime_error& e) {
+                error = e.what();
+            }
+        }
+
+        lock.lock();
+        if (!retired.empty()) {
+            mFlushedEnd = retired.back().mIndex + 1;
+            if (mFlushError.empty()) {
+                mFlushError = flushError;
+            }
+        }
+        if (prepare) {
+            mPrepared = prepared;
+            mError = error;
+        }
+        if (prepare || !retired.empty()) {
+            mReady.notify_one();
+        }
+        mWake.wait(lock, [this] {
+            return mStopping || !mRetired.empty() || (mPrepared.mMemory == nullptr && mError.empty());
+        });
+    }
+}
+
+// Constructor for JournalReader.
+// Reads the segment size from the oldest segment on disk and positions the reader at its first record.
+JournalReader::JournalReader(const std::string& directory) : mDirectory(directory), mSlotsPerSegment(0),
+                                                             mPosition(0) {
+    for (uint64_t segment : listJournalSegments(mDirectory)) {
+        mMapped = mapExistingSegment(mDirectory, segment, false);
+        if (mMapped.mMemory != nullptr) {
+            mSlotsPerSegment = static_cast<const JournalSegmentHeader*>(mMapped.mMemory)->mSlotsPerSegment;
+            mPosition = segment * mSlotsPerSegment;
+            return;
+        }
+    }
+    throw std::runtime_error(mDirectory + " holds no journal segments");
+}
+
+// Destructor for JournalReader.
+JournalReader::~JournalReader() {
+    unmap();
+}
+
+// Read function: Copies one message out of the journal.
+// Parameters:
+// - sequence: sequence number of the message.
+// - buffer: receives the payload (64 bytes).
+// - size: receives the payload size.
+// Returns:
+// - true if the message was copied, false if it is not written yet or no longer retained.
+bool JournalReader::read(uint64_t sequence, uint8_t* buffer, size_t& size) {
+    const Block* record = recordFor(sequence);
+    if (record == nullptr) {
+        return false;
+    }
+    uint64_t header = record->mHeader.load(std::memory_order_acquire);
+    if (blockSequence(header) != sequence + 1) {
+        return false;
+    }
+    size = blockSize(header);
+    copyFromBlock(buffer, record->mData, size);
+    return true;
+}
+
+// Next function: Reads the message at position() and advances past it.
+bool JournalReader::next(uint8_t* buffer, size_t& size) {
+    if (!read(mPosition, buffer, size)) {
+        return false;
+    }
+    ++mPosition;
+    return true;
+}
+
+uint64_t JournalReader::position() const {
+    return mPosition;
+}
+
+void JournalReader::seekOldest() {
+    mPosition = oldestSequence();
+}
+
+void JournalReader::seekLatest() {
+    uint64_t end = endSequence();
+    mPosition = end > oldestSequence() ? end - 1 : end;
+}
+
+void JournalReader::seekEnd() {
+    mPosition = endSequence();
+}
+
+// Seek function: Positions the reader at a sequence number.
+// Parameters:
+// - sequence: sequence number next() reads; may be ahead of the writer.
+// Returns:
+// - true if the reader moved, false if that message is no longer retained.
+bool JournalReader::seek(uint64_t sequence) {
+    if (sequence < oldestSequence()) {
+        return false;
+    }
+    mPosition = sequence;
+    return true;
+}
+
+// SeekTimestamp function: Binary searches the retained records for the first one stamped at or after a time.
+// Each probe maps the record's segment if needed, so a search costs O(log n) header loads and at most that
+// many remaps. A record retired during the search is older than every retained one and counts as too early.
+// Parameters:
+// - timestampNs: time in nanoseconds on the writer's clock.
+// Returns:
+// - true if the reader is at the first record at or after the time, false if it landed on the oldest
+//   retained record and older segments were already retired.
+bool JournalReader::seekTimestamp(uint64_t timestampNs) {
+    uint64_t oldest = oldestSequence();
+    uint64_t low = oldest;
+    uint64_t high = endSequence();
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        const Block* record = recordFor(middle);
+        if (record == nullptr || record->mHeader.load(std::memory_order_acquire) == 0
+            || record->mTimestampNs.load(std::memory_order_relaxed) < timestampNs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    mPosition = low;
+    return !(low == oldest && oldest > 0);
+}
+
+uint64_t JournalReader::oldestSequence() const {
+    std::vector<uint64_t> segments = listJournalSegments(mDirectory);
+    return segments.empty() ? mPosition : segments.front() * mSlotsPerSegment;
+}
+
+// EndSequence function: Returns the sequence number the writer appends next. Records are written in order, so
+// the headers of a segment are a written prefix followed by zeros and the boundary is found by binary search.
+// A newest segment without records may only have been prepared ahead of time, so the search falls back to
+// the segment before it.
+uint64_t JournalReader::endSequence() {
+    std::vector<uint64_t> segments = listJournalSegments(mDirectory);
+    for (size_t i = segments.size(); i-- > 0;) {
+        uint64_t first = segments[i] * mSlotsPerSegment;
+        const Block* records = recordFor(first);
+        if (records == nullptr) {
+            continue;
+        }
+        size_t low = 0;
+        size_t high = mSlotsPerSegment;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (records[middle].mHeader.load(std::memory_order_acquire) != 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (low > 0 || i == 0) {
+            return first + low;
+        }
+    }
+    return mPosition;
+}
+
+size_t JournalReader::slotsPerSegment() const {
+    return mSlotsPerSegment;
+}
+
+// RecordFor function: Returns the record for a sequence number, mapping its segment if it is not the one
+// already mapped. Returns nullptr if the segment file does not exist (yet, or any more).
+const Block* JournalReader::recordFor(uint64_t sequence) {
+    uint64_t segment = sequence / mSlotsPerSegment;
+    if (mMapped.mMemory == nullptr || mMapped.mIndex != segment) {
+        JournalSegment mapped = mapExistingSegment(mDirectory, segment, false);
+        if (mapped.mMemory == nullptr) {
+            return nullptr;
+        }
+        unmap();
+        mMapped = mapped;
+    }
+    return mMapped.records() + sequence % mSlotsPerSegment;
+}
+
+void JournalReader::unmap() {
+    unmapSegment(mMapped);
+}
@@ -0,0 +1,185 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "spmc_queue.h"
+
+// Append-only journal of memory-mapped segment files, for audit and replay (in the spirit of Chronicle Queue).
+//
+// Every message gets a sequence number. Sequence s lives in segment s / slotsPerSegment, a file named after
+// the segment index, as the record at offset kJournalHeaderSize + (s % slotsPerSegment) * sizeof(Block).
+// Records use the Block layout: the producer copies the payload (and the optional publish timestamp) straight
+// into the mapping and then release-stores the header, packing s + 1 with the size (0 means not written yet).
+// Records are never rewritten, so a reader only has to check the header once.
+//
+// The writer rolls to the next segment when the current one is full. A background thread creates the next
+// segment ahead of time (allocating its disk blocks and faulting in every page), flushes and unmaps finished
+// ones and deletes segments beyond the retention limit, so the producer never waits on the file system in
+// steady state and only takes a mutex once per segment.
+//
+// An appended record survives the writer process crashing as soon as append() returns, since it is already in
+// the page cache. It survives the machine crashing once its segment has been flushed: after the writer rolls
+// past it, after flush(), or when the writer is destroyed.
+// JournalReader maps the same files read-only and can run in another process. POSIX only (open/mmap).
+
+constexpr uint64_t kJournalMagic = 0x53504d434a524e4cull; // "SPMCJRNL"
+constexpr uint32_t kJournalVersion = 1;
+constexpr size_t kJournalHeaderSize = 128; // keeps records on 64-byte boundaries
+
+// First bytes of every segment file.
+struct JournalSegmentHeader {
+    uint64_t mMagic;
+    uint32_t mVersion;
+    uint32_t mReserved;
+    uint64_t mSlotsPerSegment;
+    uint64_t mSegment;
+};
+
+// A mapped segment file.
+struct JournalSegment {
+    uint64_t mIndex = 0;
+    void* mMemory = nullptr;
+    size_t mBytes = 0;
+
+    Block* records() const {
+        return reinterpret_cast<Block*>(static_cast<uint8_t*>(mMemory) + kJournalHeaderSize);
+    }
+};
+
+// Segment file name for a segment index, and the inverse (false if `name` is not a segment file).
+std::string journalSegmentName(uint64_t segment);
+bool parseJournalSegmentName(const std::string& name, uint64_t& segment);
+
+// Sorted indices of the segment files present in `directory`.
+std::vector<uint64_t> listJournalSegments(const std::string& directory);
+
+// Single producer side of a journal.
+class JournalWriter {
+public:
+    // Opens the journal in `directory`, creating the directory if needed. An existing journal is continued
+    // after its last record, keeping its segment size. Keeps at most `retainedSegments` segment files
+    // (0 keeps everything). Throws std::runtime_error on file system errors.
+    explicit JournalWriter(const std::string& directory, size_t slotsPerSegment = 1 << 16,
+                           size_t retainedSegments = 16);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Appends a message and returns its sequence number.
+    uint64_t append(const uint8_t* data, size_t size);
+
+    // Same as append, stamping the record with a publish time for JournalReader::seek(time_point).
+    // Timestamps must not decrease from one record to the next; records appended without one carry 0.
+    uint64_t append(const uint8_t* data, size_t size, uint64_t timestampNs);
+
+    // Sequence number the next append will use.
+    uint64_t nextSequence() const;
+
+    size_t slotsPerSegment() const;
+
+    // Writes every record appended so far to disk, waiting for finished segments still being flushed by the
+    // background thread. Throws std::runtime_error if a flush failed since the last call.
+    void flush();
+
+private:
+    void roll();
+    size_t writtenBytes() const;
+    JournalSegment createSegment(uint64_t segment) const;
+    void maintain();
+
+    std::string mDirectory;
+    size_t mSlotsPerSegment;
+    size_t mRetainedSegments;
+
+    // Producer state
+    JournalSegment mCurrent;
+    Block* mRecords;
+    uint64_t mNext;
+    uint64_t mSegmentEnd; // First sequence of the next segment
+
+    // Shared with the maintenance thread, only touched when rolling
+    std::mutex mMutex;
+    std::condition_variable mWake;  // Wakes the maintenance thread
+    std::condition_variable mReady; // Wakes the writer waiting for the next segment
+    uint64_t mActive;               // Index of the segment the writer appends to
+    JournalSegment mPrepared;
+    std::vector<JournalSegment> mRetired;
+    std::string mError;             // Why the next segment could not be created
+    uint64_t mFlushedEnd;           // Segments below this index have been flushed and unmapped
+    std::string mFlushError;        // Why flushing a finished segment failed, reported by flush()
+    bool mStopping;
+    std::thread mMaintenance;
+};
+
+// Read-only view of a journal, usable from another process while the writer is running.
+class JournalReader {
+public:
+    // Opens the journal in `directory` and positions the reader at the oldest retained message.
+    // Throws std::runtime_error if the directory holds no journal segments.
+    explicit JournalReader(const std::string& directory);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // Copies the message with the given sequence number.
+    // Returns:
+    // - false if it has not been written yet or its segment has been retired.
+    bool read(uint64_t sequence, uint8_t* buffer, size_t& size);
+
+    // Copies the message at position() and advances past it.
+    // Returns:
+    // - false if it has not been written yet (or was retired before it could be read).
+    bool next(uint8_t* buffer, size_t& size);
+
+    // Sequence number next() reads.
+    uint64_t position() const;
+
+    // Moves to the oldest retained message, the most recently written one, or the first one not written yet.
+    void seekOldest();
+    void seekLatest();
+    void seekEnd();
+
+    // Moves to the given sequence number, e.g. one checkpointed before a restart. Returns false, leaving the
+    // reader where it was, if that message's segment has been retired.
+    bool seek(uint64_t sequence);
+
+    // Moves to the first record stamped at or after `timestampNs`, by binary search over the retained
+    // records, or to seekEnd() if every record is older. Returns false if the search landed on the oldest
+    // retained record and older segments, which may have matched too, were retired.
+    bool seekTimestamp(uint64_t timestampNs);
+
+    // seekTimestamp for a time point on the clock the writer stamps records with.
+    template <typename Clock, typename Duration>
+    bool seek(std::chrono::time_point<Clock, Duration> time) {
+        return seekTimestamp(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count()));
+    }
+
+    // First sequence number of the oldest segment still on disk.
+    uint64_t oldestSequence() const;
+
+    // Sequence number the writer appends next, found by a binary search of the newest segment's headers.
+    uint64_t endSequence();
+
+    size_t slotsPerSegment() const;
+
+private:
+    const Block* recordFor(uint64_t sequence);
+    void unmap();
+
+    std::string mDirectory;
+    size_t mSlotsPerSegment;
+    JournalSegment mMapped;
+    uint64_t mPosition;
+};
+
+#endif
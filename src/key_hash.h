@@ -0,0 +1,18 @@
+#ifndef KEY_HASH_H
+#define KEY_HASH_H
+
+#include <cstdint>
+
+// Stable 64-bit key mixer (the splitmix64 finalizer). Unlike std::hash, which is the identity for
+// integers in common standard libraries, it spreads sequential keys such as instrument ids evenly and
+// gives the same result in every process and build.
+inline uint64_t mixKey(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return key;
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "keyed_dispatcher.h"
+#include <thread>
+#include <vector>
+#include "key_hash.h"
+
+namespace {
+
+// Rendezvous weight of a lane for a bucket; the highest-weighted active lane owns the bucket.
+uint64_t laneWeight(size_t bucket, size_t lane) {
+    return mixKey((static_cast<uint64_t>(bucket) << 32) ^ static_cast<uint64_t>(lane));
+}
+
+} // namespace
+
+// Constructor for KeyedDispatcher.
+// Parameters:
+// - maxConsumers: number of lanes; consumers are identified by their lane index in [0, maxConsumers).
+// - laneCapacity: capacity of each lane's ring.
+// No consumer is active until addConsumer() is called.
+KeyedDispatcher::KeyedDispatcher(size_t maxConsumers, size_t laneCapacity)
+        : mMaxConsumers(maxConsumers), mLaneCapacity(laneCapacity), mActiveCount(0),
+          mLanes(new Lane[maxConsumers]) {
+    for (size_t i = 0; i < maxConsumers; ++i) {
+        mLanes[i].mQueue = std::make_unique<SPMCQueue>(laneCapacity);
+    }
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        mOwners[bucket] = maxConsumers;
+    }
+}
+
+// Enqueue function: Adds a block to the lane that owns `key`.
+// Parameters:
+// - key: routing key, e.g. an instrument id.
+// - data: pointer to the data to be enqueued.
+// - size: size of the data to be enqueued.
+// Returns:
+// - true if the data was enqueued, false if no consumer is active or the lane is full.
+bool KeyedDispatcher::enqueue(uint64_t key, const uint8_t* data, size_t size) {
+    size_t owner = mOwners[mixKey(key) % kBuckets];
+    if (owner == mMaxConsumers) {
+        return false;
+    }
+
+    // Refuse rather than let the ring overwrite a message this lane has not completed yet
+    Lane& lane = mLanes[owner];
+    if (lane.mPublished - lane.mCompleted.load(std::memory_order_acquire) >= mLaneCapacity) {
+        return false;
+    }
+
+    lane.mQueue->enqueue(data, size);
+    ++lane.mPublished;
+    return true;
+}
+
+void KeyedDispatcher::addConsumer(size_t lane) {
+    if (lane >= mMaxConsumers || mLanes[lane].mActive) {
+        return;
+    }
+    mLanes[lane].mActive = true;
+    ++mActiveCount;
+    rebalance();
+}
+
+void KeyedDispatcher::removeConsumer(size_t lane) {
+    if (lane >= mMaxConsumers || !mLanes[lane].mActive) {
+        return;
+    }
+    mLanes[lane].mActive = false;
+    --mActiveCount;
+    rebalance();
+}
+
+size_t KeyedDispatcher::laneFor(uint64_t key) const {
+    return mOwners[mixKey(key) % kBuckets];
+}
+
+size_t KeyedDispatcher::consumerCount() const {
+    return mActiveCount;
+}
+
+size_t KeyedDispatcher::maxConsumers() const {
+    return mMaxConsumers;
+}
+
+// Rebalance function: Recomputes the owner of every bucket from the active lanes and installs the new
+// owners once every lane that gives up a bucket has completed its pending messages.
+void KeyedDispatcher::rebalance() {
+    size_t owners[kBuckets];
+    std::vector<bool> draining(mMaxConsumers, false);
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        size_t best = mMaxConsumers;
+        uint64_t bestWeight = 0;
+        for (size_t lane = 0; lane < mMaxConsumers; ++lane) {
+            uint64_t weight = laneWeight(bucket, lane);
+            if (mLanes[lane].mActive && (best == mMaxConsumers || weight > bestWeight)) {
+                best = lane;
+                bestWeight = weight;
+            }
+        }
+        owners[bucket] = best;
+
+        size_t previous = mOwners[bucket];
+        if (previous != mMaxConsumers && previous != best) {
+            draining[previous] = true;
+        }
+    }
+
+    for (size_t lane = 0; lane < mMaxConsumers; ++lane) {
+        if (draining[lane]) {
+            waitForLane(lane);
+        }
+    }
+
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        mOwners[bucket] = owners[bucket];
+    }
+}
+
+// WaitForLane function: Spins until the lane's consumer has completed everything published to it.
+void KeyedDispatcher::waitForLane(size_t lane) const {
+    const Lane& target = mLanes[lane];
+    while (target.mCompleted.load(std::memory_order_acquire) < target.mPublished) {
+        std::this_thread::yield();
+    }
+}
+
+// Constructor for KeyedConsumer.
+// Parameters:
+// - dispatcher: the dispatcher whose lane this consumer drains.
+// - lane: lane index; the producer activates it with addConsumer().
+KeyedConsumer::KeyedConsumer(KeyedDispatcher& dispatcher, size_t lane)
+        : mLane(dispatcher.mLanes[lane]), mDequeued(mLane.mCompleted.load(std::memory_order_relaxed)) {
+}
+
+// Dequeue function: Completes the previous message, then retrieves the next block from this lane.
+// Parameters:
+// - buffer: pointer to the buffer where the data will be copied.
+// - size: reference to a variable to store the size of the dequeued data.
+// Returns:
+// - true if data was dequeued, false if the lane is empty.
+bool KeyedConsumer::dequeue(uint8_t* buffer, size_t& size) {
+    complete();
+    if (!mLane.mQueue->dequeue(buffer, size)) {
+        return false;
+    }
+    ++mDequeued;
+    return true;
+}
+
+void KeyedConsumer::complete() {
+    if (mLane.mCompleted.load(std::memory_order_relaxed) != mDequeued) {
+        mLane.mCompleted.store(mDequeued, std::memory_order_release);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef KEYED_DISPATCHER_H
+#define KEYED_DISPATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "spmc_queue.h"
+
+// Key-affinity dispatch: one SPMCQueue lane per consumer, with every key routed to a single lane so that
+// messages for the same key are handled by one consumer, in enqueue order.
+//
+// Keys are hashed (mixKey) into kBuckets buckets and each bucket is owned by one active lane, chosen by
+// rendezvous hashing. When a consumer joins or leaves, only the buckets that change owner move: a joining
+// consumer takes roughly 1/N of the buckets, and a leaving consumer's buckets are spread over the others.
+// Before a moved bucket is handed over, the producer waits until its old lane has completed everything
+// already published to it, so a key never has messages in flight on two consumers at once.
+//
+// Everything except KeyedConsumer runs on the single producer thread, including membership changes.
+class KeyedDispatcher {
+public:
+    static constexpr size_t kBuckets = 1024;
+
+    KeyedDispatcher(size_t maxConsumers, size_t laneCapacity);
+
+    // Enqueue function: Routes a block to the lane that owns `key`.
+    // Returns false if no consumer is active or the lane has no room left.
+    bool enqueue(uint64_t key, const uint8_t* data, size_t size);
+
+    // Activates a lane and moves its share of buckets to it. Blocks until the previous owners of those
+    // buckets have completed their pending messages.
+    void addConsumer(size_t lane);
+
+    // Deactivates a lane and hands its buckets to the remaining lanes. Blocks until the leaving consumer
+    // has completed its pending messages, so it must keep consuming until this returns.
+    void removeConsumer(size_t lane);
+
+    // Lane that currently owns `key`, or maxConsumers() if no consumer is active.
+    size_t laneFor(uint64_t key) const;
+
+    size_t consumerCount() const;
+
+    size_t maxConsumers() const;
+
+private:
+    friend class KeyedConsumer;
+
+    struct alignas(64) Lane {
+        std::unique_ptr<SPMCQueue> mQueue;
+        bool mActive = false;
+        uint64_t mPublished = 0;                // producer-owned
+        alignas(64) std::atomic<uint64_t> mCompleted{0}; // consumer-owned
+    };
+
+    void rebalance();
+    void waitForLane(size_t lane) const;
+
+    size_t mMaxConsumers;
+    size_t mLaneCapacity;
+    size_t mActiveCount;
+    std::unique_ptr<Lane[]> mLanes;
+    size_t mOwners[kBuckets];
+};
+
+// Consumer handle for one lane of a KeyedDispatcher, owned by one consumer thread.
+// A message counts as completed when the consumer comes back for the next one (or calls complete()),
+// which is what lets the dispatcher move a key without reordering its messages.
+class KeyedConsumer {
+public:
+    KeyedConsumer(KeyedDispatcher& dispatcher, size_t lane);
+
+    // Dequeue function: Completes the previous message, then retrieves the next block from this lane.
+    bool dequeue(uint8_t* buffer, size_t& size);
+
+    // Marks the last dequeued message as completed without asking for another one.
+    void complete();
+
+private:
+    KeyedDispatcher::Lane& mLane;
+    uint64_t mDequeued;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "mpmc_queue.h"
+#include <thread>
+#include "block_copy.h"
+
+// Constructor for MPMCQueue.
+// Initializes the queue with a given capacity, setting the head ticket and tail to 0.
+MPMCQueue::MPMCQueue(size_t capacity) : mCapacity(capacity), mHead(0), mTail(0) {
+    mQueue = new Block[capacity];
+    for (size_t i = 0; i < capacity; ++i) {
+        mQueue[i].mHeader.store(0);
+    }
+}
+
+// Destructor for MPMCQueue.
+MPMCQueue::~MPMCQueue() {
+    delete[] mQueue;
+}
+
+// Enqueue function: Adds a block of data to the queue. Safe to call from any number of threads.
+// Parameters:
+// - data: pointer to the data to be enqueued.
+// - size: size of the data to be enqueued.
+// Returns:
+// - true if the data was successfully enqueued.
+bool MPMCQueue::enqueue(const uint8_t* data, size_t size) {
+    size_t ticket = mHead.fetch_add(1, std::memory_order_relaxed);
+    Block& block = mQueue[ticket % mCapacity];
+    uint64_t lap = ticket / mCapacity;
+
+    // Take the block for writing by moving its header to this lap's odd sequence. An odd sequence from an
+    // earlier lap means the producer holding the ticket one lap earlier is still writing it, which only
+    // happens when the ring is lapped; wait for it to publish. A sequence from a later lap means producers
+    // a whole lap ahead have reused the block already, so this block is overwritten before it is published.
+    uint64_t header = block.mHeader.load(std::memory_order_acquire);
+    while (true) {
+        uint64_t sequence = blockSequence(header);
+        if (sequence >= writingSequence(lap)) {
+            return true;
+        }
+        if (sequence % 2 == 1) {
+            std::this_thread::yield();
+            header = block.mHeader.load(std::memory_order_acquire);
+            continue;
+        }
+        if (block.mHeader.compare_exchange_weak(header, packBlockHeader(writingSequence(lap), 0),
+                                                std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    copyToBlock(block.mData, data, size);
+
+    block.mHeader.store(packBlockHeader(readySequence(lap), size), std::memory_order_release);
+
+    return true;
+}
+
+// Dequeue function: Retrieves a block of data from the queue.
+// Parameters:
+// - buffer: pointer to the buffer where the data will be copied.
+// - size: reference to a variable to store the size of the dequeued data.
+// Returns:
+// - true if data was successfully dequeued, false if the block is not ready to be read.
+bool MPMCQueue::dequeue(uint8_t* buffer, size_t& size) {
+    return tryDequeue(buffer, size) == DequeueResult::Success;
+}
+
+// TryDequeue function: Same as dequeue, but reports why an attempt failed.
+// Consumers follow SPMCQueue's protocol. Tickets are published in any order, but the tail only moves
+// past a block once that block carries its lap's ready sequence, so consumers still see each producer's
+// blocks in ticket order.
+DequeueResult MPMCQueue::tryDequeue(uint8_t* buffer, size_t& size) {
+    size_t localTail = mTail.load(std::memory_order_relaxed);
+    Block& block = mQueue[localTail % mCapacity];
+    uint64_t expected = readySequence(localTail / mCapacity);
+    uint64_t header = block.mHeader.load(std::memory_order_acquire);
+
+    if (blockSequence(header) != expected) {
+        if (blockSequence(header) < expected) {
+            return DequeueResult::Empty;
+        }
+        skipOverwritten(localTail);
+        return DequeueResult::Contended;
+    }
+
+    if (!mTail.compare_exchange_strong(localTail, localTail + 1, std::memory_order_relaxed)) {
+        return DequeueResult::Contended;
+    }
+
+    size = blockSize(header);
+
+    copyFromBlock(buffer, block.mData, size);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (block.mHeader.load(std::memory_order_relaxed) != header) {
+        return DequeueResult::Contended; // Overwritten while copying
+    }
+
+    return DequeueResult::Success;
+}
+
+// SkipOverwritten function: Moves the tail past blocks that producers have already overwritten.
+void MPMCQueue::skipOverwritten(size_t localTail) {
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t oldest = head > mCapacity ? head - mCapacity : 0;
+    if (oldest > localTail) {
+        mTail.compare_exchange_strong(localTail, oldest, std::memory_order_relaxed);
+    }
+}
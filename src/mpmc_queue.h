@@ -0,0 +1,32 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include "spmc_queue.h"
+
+// Multi-producer variant of SPMCQueue sharing its Block format and version protocol.
+// Producers claim a slot with a fetch_add ticket on mHead instead of SPMCQueue's producer-owned
+// increment, take the block with a CAS on its header, then publish it exactly like SPMCQueue does.
+// Use SPMCQueue when there is only one producer; it doesn't pay for the ticket and header RMWs.
+class MPMCQueue {
+public:
+    MPMCQueue(size_t capacity);
+    ~MPMCQueue();
+
+    bool enqueue(const uint8_t* data, size_t size);
+
+    bool dequeue(uint8_t* buffer, size_t& size);
+
+    DequeueResult tryDequeue(uint8_t* buffer, size_t& size);
+
+private:
+    void skipOverwritten(size_t localTail);
+
+    size_t mCapacity;
+    alignas(64) std::atomic<size_t> mHead; // Ticket counter, never wrapped
+    alignas(64) std::atomic<size_t> mTail; // Next position to read, never wrapped
+    Block* mQueue;
+};
+
+#endif
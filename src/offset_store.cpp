@@ -0,0 +1,210 @@
+#include "offset_store.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::runtime_error offsetError(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+// Synchronously writes the mapped layout to disk. Returns an error message, empty on success.
+std::string syncLayout(OffsetStoreLayout* layout, const std::string& path) {
+    if (msync(layout, sizeof(OffsetStoreLayout), MS_SYNC) == 0) {
+        return std::string();
+    }
+    return offsetError("msync", path).what();
+}
+
+// Holds the file's exclusive flock for the lifetime of the object, serialising slot registration and
+// first-time initialisation across processes.
+class FileLock {
+public:
+    explicit FileLock(int fd) : mFd(fd) {
+        while (flock(mFd, LOCK_EX) != 0 && errno == EINTR) {
+        }
+    }
+
+    ~FileLock() {
+        flock(mFd, LOCK_UN);
+    }
+
+private:
+    int mFd;
+};
+
+} // namespace
+
+ConsumerOffset::ConsumerOffset(OffsetSlot* slot) : mSlot(slot) {
+}
+
+uint64_t ConsumerOffset::load(uint64_t fallback) const {
+    if (mSlot->mCommitted.load(std::memory_order_acquire) == 0) {
+        return fallback;
+    }
+    return mSlot->mOffset.load(std::memory_order_acquire);
+}
+
+// Commit function: Stores the consumer's offset in the shared mapping.
+// Parameters:
+// - offset: next sequence number the consumer will read.
+void ConsumerOffset::commit(uint64_t offset) {
+    mSlot->mOffset.store(offset, std::memory_order_release);
+    if (mSlot->mCommitted.load(std::memory_order_relaxed) == 0) {
+        mSlot->mCommitted.store(1, std::memory_order_release);
+    }
+}
+
+const char* ConsumerOffset::name() const {
+    return mSlot->mName;
+}
+
+// Constructor for OffsetStore.
+// Maps the offset file, initialising it under the file lock if it is new or its creator died before finishing.
+OffsetStore::OffsetStore(const std::string& path) : mPath(path), mFd(-1), mLayout(nullptr), mRunning(false) {
+    mFd = open(mPath.c_str(), O_CREAT | O_RDWR, 0644);
+    if (mFd < 0) {
+        throw offsetError("open", mPath);
+    }
+
+    FileLock lock(mFd);
+    struct stat info;
+    if (fstat(mFd, &info) != 0) {
+        close(mFd);
+        throw offsetError("fstat", mPath);
+    }
+    if (info.st_size == 0 && ftruncate(mFd, sizeof(OffsetStoreLayout)) != 0) {
+        close(mFd);
+        throw offsetError("ftruncate", mPath);
+    }
+    if (info.st_size != 0 && static_cast<size_t>(info.st_size) < sizeof(OffsetStoreLayout)) {
+        close(mFd);
+        throw std::runtime_error(mPath + " is not a compatible offset file");
+    }
+    void* memory = mmap(nullptr, sizeof(OffsetStoreLayout), PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+    if (memory == MAP_FAILED) {
+        close(mFd);
+        throw offsetError("mmap", mPath);
+    }
+
+    // The magic is written last, so a zero magic means the file is new or its creator crashed after sizing it
+    mLayout = static_cast<OffsetStoreLayout*>(memory);
+    if (mLayout->mMagic == 0) {
+        mLayout->mVersion = kOffsetStoreVersion;
+        mLayout->mMagic = kOffsetStoreMagic;
+        msync(mLayout, sizeof(OffsetStoreLayout), MS_SYNC);
+    } else if (mLayout->mMagic != kOffsetStoreMagic || mLayout->mVersion != kOffsetStoreVersion) {
+        munmap(memory, sizeof(OffsetStoreLayout));
+        close(mFd);
+        throw std::runtime_error(mPath + " is not a compatible offset file");
+    }
+}
+
+// Destructor for OffsetStore.
+// Stops the flush thread and writes the final offsets to disk. Flush errors have no caller left to report to
+// here; call stop() and flush() first to see them.
+OffsetStore::~OffsetStore() {
+    try {
+        stop();
+    } catch (const std::runtime_error&) {
+    }
+    syncLayout(mLayout, mPath);
+    munmap(mLayout, sizeof(OffsetStoreLayout));
+    close(mFd);
+}
+
+// Consumer function: Looks up a named consumer, claiming a free slot for a new name.
+// Parameters:
+// - name: consumer name, at most kOffsetNameSize - 1 characters.
+// Returns:
+// - a handle on the consumer's offset.
+ConsumerOffset OffsetStore::consumer(const std::string& name) {
+    if (name.empty() || name.size() >= kOffsetNameSize) {
+        throw std::invalid_argument("offset name must be 1 to " + std::to_string(kOffsetNameSize - 1) + " characters");
+    }
+
+    FileLock lock(mFd);
+    OffsetSlot* unused = nullptr;
+    for (OffsetSlot& slot : mLayout->mSlots) {
+        if (slot.mName[0] == '\0') {
+            if (unused == nullptr) {
+                unused = &slot;
+            }
+        } else if (name == slot.mName) {
+            return ConsumerOffset(&slot);
+        }
+    }
+    if (unused == nullptr) {
+        throw std::runtime_error(mPath + " has no free consumer slot");
+    }
+
+    unused->mOffset.store(0, std::memory_order_relaxed);
+    unused->mCommitted.store(0, std::memory_order_relaxed);
+    std::memcpy(unused->mName, name.c_str(), name.size() + 1);
+    return ConsumerOffset(unused);
+}
+
+// Flush function: Synchronously writes the mapping to disk, persisting every commit made so far in one go.
+// Throws std::runtime_error if this flush failed, or else the first background flush that failed since the
+// last report.
+void OffsetStore::flush() {
+    std::string error = syncLayout(mLayout, mPath);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (error.empty()) {
+            error.swap(mFlushError);
+        }
+        mFlushError.clear();
+    }
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+// Start function: Flushes periodically from a background thread.
+// Parameters:
+// - interval: time between two flushes, i.e. how many milliseconds of commits a machine crash can lose.
+void OffsetStore::start(std::chrono::milliseconds interval) {
+    if (mRunning.exchange(true)) {
+        return;
+    }
+    mThread = std::thread([this, interval]() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (!mWake.wait_for(lock, interval, [this] { return !mRunning.load(std::memory_order_relaxed); })) {
+            lock.unlock();
+            std::string error = syncLayout(mLayout, mPath);
+            lock.lock();
+            if (mFlushError.empty()) {
+                mFlushError = error; // Kept for the next flush() or stop()
+            }
+        }
+    });
+}
+
+// Stop function: Stops the background thread, if any, without waiting for the rest of its interval.
+// Throws std::runtime_error if one of its flushes failed and no flush() has reported it yet.
+void OffsetStore::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mRunning.exchange(false)) {
+            return;
+        }
+    }
+    mWake.notify_one();
+    mThread.join();
+
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        error.swap(mFlushError);
+    }
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef OFFSET_STORE_H
+#define OFFSET_STORE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Durable positions for named consumers, so a restarted consumer resumes where it stopped.
+//
+// The offsets live in a small memory-mapped file that every process using the store maps shared. A commit
+// is a single release store to the consumer's own cache line in that mapping: no system call, no lock, and
+// the value survives the consumer process crashing because it is already in the page cache. Getting it onto
+// the disk is batched: flush() (or the background thread started with start()) msyncs the whole file, so
+// one write covers every commit made since the last flush. A restarted consumer re-opens the store, looks
+// up its name and seeks its SPMCCursor or JournalReader to the offset, all in microseconds.
+//
+// An offset is the next sequence number the consumer will read. Each name is committed by one thread at a
+// time. POSIX only (open/mmap/flock).
+
+constexpr uint64_t kOffsetStoreMagic = 0x53504d434f464653ull; // "SPMCOFFS"
+constexpr uint32_t kOffsetStoreVersion = 1;
+constexpr size_t kMaxOffsetConsumers = 64;
+constexpr size_t kOffsetNameSize = 48; // including the terminating zero
+
+// One named consumer, alone on its cache line.
+struct alignas(64) OffsetSlot {
+    char mName[kOffsetNameSize];      // empty if the slot is free
+    std::atomic<uint64_t> mOffset;    // next sequence to read
+    std::atomic<uint64_t> mCommitted; // non-zero once an offset has been committed
+};
+
+// Layout of the offset file.
+struct OffsetStoreLayout {
+    uint64_t mMagic;
+    uint32_t mVersion;
+    uint32_t mReserved;
+    alignas(64) OffsetSlot mSlots[kMaxOffsetConsumers];
+};
+
+class OffsetStore;
+
+// Handle on one named consumer's offset. Cheap to copy; valid while its OffsetStore is alive.
+class ConsumerOffset {
+public:
+    // Last committed offset, or `fallback` if the consumer has never committed.
+    uint64_t load(uint64_t fallback = 0) const;
+
+    // Records the next sequence to read. Visible to other processes at once, on disk after the next flush.
+    void commit(uint64_t offset);
+
+    const char* name() const;
+
+private:
+    friend class OffsetStore;
+    explicit ConsumerOffset(OffsetSlot* slot);
+
+    OffsetSlot* mSlot;
+};
+
+class OffsetStore {
+public:
+    // Opens the offset file at `path`, creating it if needed. Throws std::runtime_error if it cannot be
+    // created or is not an offset file.
+    explicit OffsetStore(const std::string& path);
+    ~OffsetStore();
+
+    OffsetStore(const OffsetStore&) = delete;
+    OffsetStore& operator=(const OffsetStore&) = delete;
+
+    // Returns the offset of `name`, registering it if it is new. Throws std::invalid_argument if the name
+    // is empty or too long, std::runtime_error if every slot is taken.
+    ConsumerOffset consumer(const std::string& name);
+
+    // Writes every commit made so far to disk. Throws std::runtime_error if it, or an earlier background
+    // flush not reported yet, failed.
+    void flush();
+
+    // Flushes every `interval` from a background thread until stop() or destruction. stop() returns without
+    // waiting for the current interval to end, and throws std::runtime_error if a background flush failed.
+    void start(std::chrono::milliseconds interval);
+    void stop();
+
+private:
+    std::string mPath;
+    int mFd;
+    OffsetStoreLayout* mLayout;
+    std::atomic<bool> mRunning;
+    std::mutex mMutex;             // Guards mRunning changes against the flush thread's wait, and mFlushError
+    std::condition_variable mWake; // Wakes the flush thread early on stop()
+    std::string mFlushError;       // First background flush failure not reported yet
+    std::thread mThread;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "pipeline_ring.h"
+#include <stdexcept>
+#include <string>
+#include "block_copy.h"
+
+// Constructor for PipelineRing.
+// Parameters:
+// - capacity: number of slots; the producer can be at most this many messages ahead of the final stages.
+PipelineRing::PipelineRing(size_t capacity)
+        : mCapacity(capacity), mSlots(new Slot[capacity]), mCursors(new StageCursor[kMaxStages]), mPublished(0),
+          mGateCached(0) {
+}
+
+size_t PipelineRing::addStage(const std::vector<size_t>& upstream) {
+    size_t stage = mStages.size();
+    if (stage == kMaxStages) {
+        throw std::invalid_argument("PipelineRing supports at most " + std::to_string(kMaxStages) + " stages");
+    }
+    for (size_t parent : upstream) {
+        if (parent >= stage) {
+            throw std::invalid_argument("PipelineRing upstream stage " + std::to_string(parent) + " does not exist");
+        }
+    }
+
+    StageState state;
+    state.mUpstream = upstream;
+    mStages.push_back(state);
+
+    // The new stage is final until another stage depends on it; its upstream stages no longer are
+    mFinalStages.push_back(stage);
+    for (size_t parent : upstream) {
+        for (size_t i = 0; i < mFinalStages.size(); ++i) {
+            if (mFinalStages[i] == parent) {
+                mFinalStages.erase(mFinalStages.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+    }
+    return stage;
+}
+
+// Publish function: Copies a message into the next slot and makes it visible to the first stages.
+// Parameters:
+// - data: pointer to the data to be published.
+// - size: size of the data to be published (at most 64 bytes).
+// Returns:
+// - true if the message was published, false if the slot is still in use by a final stage.
+bool PipelineRing::tryPublish(const uint8_t* data, size_t size) {
+    uint64_t sequence = mPublished.load(std::memory_order_relaxed);
+    if (sequence - mGateCached >= mCapacity) {
+        mGateCached = minimumFinalCursor();
+        if (sequence - mGateCached >= mCapacity) {
+            return false;
+        }
+    }
+
+    Slot& slot = mSlots[sequence % mCapacity];
+    copyToBlock(slot.mData, data, size);
+    slot.mSize = size;
+
+    mPublished.store(sequence + 1, std::memory_order_release);
+    return true;
+}
+
+uint64_t PipelineRing::cursor(size_t stage) const {
+    return mCursors[stage].mSequence.load(std::memory_order_acquire);
+}
+
+uint64_t PipelineRing::published() const {
+    return mPublished.load(std::memory_order_acquire);
+}
+
+size_t PipelineRing::stageCount() const {
+    return mStages.size();
+}
+
+// AvailableTo function: Returns the first sequence `stage` may not process yet, the minimum cursor of its
+// upstream stages or the producer's published count. The acquire loads make the upstream writes visible.
+uint64_t PipelineRing::availableTo(size_t stage) const {
+    const std::vector<size_t>& upstream = mStages[stage].mUpstream;
+    if (upstream.empty()) {
+        return mPublished.load(std::memory_order_acquire);
+    }
+    uint64_t minimum = UINT64_MAX;
+    for (size_t parent : upstream) {
+        uint64_t sequence = mCursors[parent].mSequence.load(std::memory_order_acquire);
+        if (sequence < minimum) {
+            minimum = sequence;
+        }
+    }
+    return minimum;
+}
+
+// MinimumFinalCursor function: Returns the lowest cursor among the final stages, below which every slot can
+// be reused. With no stages declared nothing is ever released.
+uint64_t PipelineRing::minimumFinalCursor() const {
+    if (mFinalStages.empty()) {
+        return 0;
+    }
+    uint64_t minimum = UINT64_MAX;
+    for (size_t stage : mFinalStages) {
+        uint64_t sequence = mCursors[stage].mSequence.load(std::memory_order_acquire);
+        if (sequence < minimum) {
+            minimum = sequence;
+        }
+    }
+    return minimum;
+}
@@ -0,0 +1,113 @@
+#ifndef PIPELINE_RING_H
+#define PIPELINE_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Disruptor-style ring for pipelines of dependent consumer stages (e.g. decode -> risk -> journal).
+//
+// Every stage sees every message, in order, straight from the ring: there is no copy between stages. Each
+// stage publishes a cursor, the next sequence it will process, on its own cache line. A stage may only
+// process sequence n once all of its upstream stages (or the producer, for a stage with none) are past n,
+// and the producer may only reuse a slot once every final stage, those no other stage depends on, is past
+// it. A stage processes the whole run available to it and then publishes its cursor once.
+//
+// A stage owns a slot while processing it and may modify the payload in place, for downstream stages to
+// read. Stages are declared with addStage() before any thread starts publishing or processing. There is one
+// producer thread and one thread per stage.
+class PipelineRing {
+public:
+    static constexpr size_t kMaxStages = 16;
+
+    explicit PipelineRing(size_t capacity);
+
+    PipelineRing(const PipelineRing&) = delete;
+    PipelineRing& operator=(const PipelineRing&) = delete;
+
+    // Declares a stage that waits on the given upstream stages, or on the producer if the list is empty.
+    // Returns the stage id. Throws std::invalid_argument if an upstream id does not name an earlier stage
+    // or more than kMaxStages stages are declared.
+    size_t addStage(const std::vector<size_t>& upstream = {});
+
+    // Publish function: Copies a message into the next slot. Producer thread only.
+    // Returns false if the final stages have not released the slot yet.
+    bool tryPublish(const uint8_t* data, size_t size);
+
+    // Processes the messages available to `stage`, up to maxCount, calling
+    // fn(uint64_t sequence, uint8_t* data, size_t size) on each in order. Returns the number processed.
+    template <typename F>
+    size_t process(size_t stage, F&& fn, size_t maxCount = SIZE_MAX);
+
+    // Next sequence `stage` will process.
+    uint64_t cursor(size_t stage) const;
+
+    // Number of messages published so far.
+    uint64_t published() const;
+
+    size_t stageCount() const;
+
+private:
+    struct alignas(64) Slot {
+        size_t mSize;
+        alignas(64) uint8_t mData[64];
+    };
+
+    // Cursor of a stage, written only by that stage's thread
+    struct alignas(64) StageCursor {
+        std::atomic<uint64_t> mSequence{0};
+    };
+
+    // Stage-private state, touched only by that stage's thread after setup
+    struct alignas(64) StageState {
+        std::vector<size_t> mUpstream;
+        uint64_t mAvailable = 0; // Cached bound: sequences below it are known to be processable
+    };
+
+    uint64_t availableTo(size_t stage) const;
+    uint64_t minimumFinalCursor() const;
+
+    size_t mCapacity;
+    std::unique_ptr<Slot[]> mSlots;
+    std::unique_ptr<StageCursor[]> mCursors;
+    std::vector<StageState> mStages;
+    std::vector<size_t> mFinalStages;
+
+    // Producer side
+    alignas(64) std::atomic<uint64_t> mPublished; // Sequences below it hold published messages
+    uint64_t mGateCached;                         // Last minimum cursor of the final stages seen
+};
+
+// Process function: Runs one batch of `stage`.
+// Parameters:
+// - stage: id returned by addStage(); only that stage's thread may call this.
+// - fn: handler called as fn(uint64_t sequence, uint8_t* data, size_t size) for each message.
+// - maxCount: maximum number of messages to process in this call.
+// Returns:
+// - the number of messages processed, 0 if the upstream stages have nothing new.
+template <typename F>
+size_t PipelineRing::process(size_t stage, F&& fn, size_t maxCount) {
+    StageState& state = mStages[stage];
+    StageCursor& cursor = mCursors[stage];
+    uint64_t next = cursor.mSequence.load(std::memory_order_relaxed);
+
+    if (next >= state.mAvailable) {
+        state.mAvailable = availableTo(stage);
+        if (next >= state.mAvailable) {
+            return 0;
+        }
+    }
+
+    uint64_t end = state.mAvailable - next < maxCount ? state.mAvailable : next + maxCount;
+    for (uint64_t sequence = next; sequence < end; ++sequence) {
+        Slot& slot = mSlots[sequence % mCapacity];
+        fn(sequence, static_cast<uint8_t*>(slot.mData), slot.mSize);
+    }
+
+    // One release store per batch hands the whole run to the downstream stages (and the producer)
+    cursor.mSequence.store(end, std::memory_order_release);
+    return static_cast<size_t>(end - next);
+}
+
+#endif
@@ -0,0 +1,107 @@
+#include "sharded_queue.h"
+#include <cstring>
+#include "key_hash.h"
+
+// Constructor for ShardedSPMCQueue.
+// Parameters:
+// - shardCount: number of independent rings (at least 1).
+// - shardCapacity: capacity of each ring.
+ShardedSPMCQueue::ShardedSPMCQueue(size_t shardCount, size_t shardCapacity) : mNextShard(0) {
+    if (shardCount == 0) {
+        shardCount = 1;
+    }
+    for (size_t i = 0; i < shardCount; ++i) {
+        mShards.push_back(std::make_unique<SPMCQueue>(shardCapacity));
+    }
+}
+
+bool ShardedSPMCQueue::enqueue(const uint8_t* data, size_t size) {
+    size_t index = mNextShard;
+    mNextShard = index + 1 == mShards.size() ? 0 : index + 1;
+    return mShards[index]->enqueue(data, size);
+}
+
+bool ShardedSPMCQueue::enqueue(uint64_t key, const uint8_t* data, size_t size) {
+    return mShards[shardFor(key)]->enqueue(data, size);
+}
+
+size_t ShardedSPMCQueue::shardCount() const {
+    return mShards.size();
+}
+
+size_t ShardedSPMCQueue::shardFor(uint64_t key) const {
+    return mixKey(key) % mShards.size();
+}
+
+SPMCQueue& ShardedSPMCQueue::shard(size_t index) {
+    return *mShards[index];
+}
+
+// Constructor for ShardConsumer.
+// Parameters:
+// - queue: the sharded queue to consume from.
+// - homeShard: the shard this consumer normally drains (wrapped to the shard count).
+ShardConsumer::ShardConsumer(ShardedSPMCQueue& queue, size_t homeShard)
+        : mQueue(queue), mHomeShard(homeShard % queue.shardCount()), mNextVictim(mHomeShard + 1),
+          mStashBegin(0), mStashEnd(0), mStolen(0) {
+}
+
+// Dequeue function: Retrieves a block from the stash, the home shard or, failing both, a stolen batch.
+// Parameters:
+// - buffer: pointer to the buffer where the data will be copied.
+// - size: reference to a variable to store the size of the dequeued data.
+// Returns:
+// - true if data was dequeued, false if every shard was empty.
+bool ShardConsumer::dequeue(uint8_t* buffer, size_t& size) {
+    if (mStashBegin == mStashEnd) {
+        if (mQueue.shard(mHomeShard).dequeue(buffer, size)) {
+            return true;
+        }
+        if (!steal()) {
+            return false;
+        }
+    }
+
+    size = mStashSizes[mStashBegin];
+    std::memcpy(buffer, mStash[mStashBegin], size);
+    ++mStashBegin;
+    return true;
+}
+
+uint64_t ShardConsumer::stolen() const {
+    return mStolen;
+}
+
+// Steal function: Moves up to kStealBatch blocks from the first non-empty victim shard into the stash with
+// one batch claim.
+// Returns:
+// - true if anything was stolen.
+bool ShardConsumer::steal() {
+    size_t shardCount = mQueue.shardCount();
+    mStashBegin = 0;
+    mStashEnd = 0;
+
+    for (size_t attempt = 0; attempt + 1 < shardCount; ++attempt) {
+        size_t victim = mNextVictim % shardCount;
+        mNextVictim = victim + 1;
+        if (victim == mHomeShard) {
+            victim = mNextVictim % shardCount;
+            mNextVictim = victim + 1;
+        }
+
+        SPMCQueue& queue = mQueue.shard(victim);
+        size_t backlog = queue.depth();
+        size_t batch = backlog / 2 < kStealBatch ? backlog / 2 : kStealBatch;
+        if (batch == 0) {
+            batch = 1; // Still take a lone block so no message waits on a busy owner
+        }
+
+        // One CAS on the victim's tail for the whole batch, so the owner sees one competing claim, not batch
+        mStashEnd = queue.dequeueBatch(&mStash[0][0], mStashSizes, batch);
+        if (mStashEnd > 0) {
+            mStolen += mStashEnd;
+            return true;
+        }
+    }
+    return false;
+}
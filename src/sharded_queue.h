@@ -0,0 +1,61 @@
+#ifndef SHARDED_QUEUE_H
+#define SHARDED_QUEUE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "spmc_queue.h"
+
+// K independent SPMCQueue rings fed by one producer.
+// Each consumer has a home shard, so in steady state every mTail is touched by a single consumer;
+// a consumer whose home shard runs dry steals a batch from another shard's tail (see ShardConsumer).
+class ShardedSPMCQueue {
+public:
+    ShardedSPMCQueue(size_t shardCount, size_t shardCapacity);
+
+    // Enqueue function: Adds a block to the next shard in round-robin order. Single producer only.
+    bool enqueue(const uint8_t* data, size_t size);
+
+    // Enqueue function: Adds a block to the shard selected by hashing `key`, so equal keys always
+    // land in the same shard.
+    bool enqueue(uint64_t key, const uint8_t* data, size_t size);
+
+    size_t shardCount() const;
+
+    size_t shardFor(uint64_t key) const;
+
+    SPMCQueue& shard(size_t index);
+
+private:
+    std::vector<std::unique_ptr<SPMCQueue>> mShards;
+    size_t mNextShard; // Round-robin cursor, producer-owned
+};
+
+// Consumer handle for a ShardedSPMCQueue, owned by one consumer thread.
+// It drains its home shard first. When that is empty it visits the other shards in order and steals
+// up to kStealBatch blocks (at most half of the victim's backlog) into a local stash, claiming them with
+// a single CAS on the victim's tail, and serves the stash before going back to the shards.
+class ShardConsumer {
+public:
+    static constexpr size_t kStealBatch = 16;
+
+    ShardConsumer(ShardedSPMCQueue& queue, size_t homeShard);
+
+    bool dequeue(uint8_t* buffer, size_t& size);
+
+    uint64_t stolen() const;
+
+private:
+    bool steal();
+
+    ShardedSPMCQueue& mQueue;
+    size_t mHomeShard;
+    size_t mNextVictim;
+    uint8_t mStash[kStealBatch][64];   // Stolen payloads, filled by one SPMCQueue::dequeueBatch
+    size_t mStashSizes[kStealBatch];
+    size_t mStashBegin;
+    size_t mStashEnd;
+    uint64_t mStolen;
+};
+
+#endif
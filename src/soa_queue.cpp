@@ -0,0 +1,242 @@
+#include "soa_queue.h"
+#include "block_copy.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Index of the lowest set bit of a nonzero mask.
+inline unsigned int countTrailingZeros(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return static_cast<unsigned int>(bit);
+#else
+    unsigned int bit = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+} // namespace
+
+// Constructor for SoASPMCQueue.
+// Allocates the header lines and payloads separately and marks every block as never written.
+SoASPMCQueue::SoASPMCQueue(size_t capacity)
+        : mCapacity(capacity), mHeaderLines(new HeaderLine[(capacity + kHeadersPerLine - 1) / kHeadersPerLine]),
+          mPayloads(new Payload[capacity]), mHead(0), mTail(0) {
+    for (size_t i = 0; i < capacity; ++i) {
+        header(i).store(0);
+    }
+}
+
+// Destructor for SoASPMCQueue.
+SoASPMCQueue::~SoASPMCQueue() = default;
+
+// Enqueue function: Adds a block of data to the queue. Single producer only; same protocol as SPMCQueue.
+// Parameters:
+// - data: pointer to the data to be enqueued.
+// - size: size of the data to be enqueued.
+// Returns:
+// - true if the data was successfully enqueued.
+bool SoASPMCQueue::enqueue(const uint8_t* data, size_t size) {
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t index = head % mCapacity;
+    uint64_t lap = head / mCapacity;
+    std::atomic<uint64_t>& slot = header(index);
+
+    slot.store(packBlockHeader(writingSequence(lap), 0), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    copyToBlock(mPayloads[index].mData, data, size);
+
+    slot.store(packBlockHeader(readySequence(lap), size), std::memory_order_release);
+
+    mHead.store(head + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool SoASPMCQueue::dequeue(uint8_t* buffer, size_t& size) {
+    return tryDequeue(buffer, size) == DequeueResult::Success;
+}
+
+// TryDequeue function: Dequeues a single block, reporting why an attempt failed like SPMCQueue::tryDequeue.
+DequeueResult SoASPMCQueue::tryDequeue(uint8_t* buffer, size_t& size) {
+    size_t localTail = mTail.load(std::memory_order_relaxed);
+    size_t index = localTail % mCapacity;
+    uint64_t expected = readySequence(localTail / mCapacity);
+    std::atomic<uint64_t>& slot = header(index);
+    uint64_t value = slot.load(std::memory_order_acquire);
+
+    if (blockSequence(value) != expected) {
+        if (blockSequence(value) < expected) {
+            return DequeueResult::Empty;
+        }
+        skipOverwritten(localTail);
+        return DequeueResult::Contended;
+    }
+
+    if (!mTail.compare_exchange_strong(localTail, localTail + 1, std::memory_order_relaxed)) {
+        return DequeueResult::Contended;
+    }
+
+    size = blockSize(value);
+    copyFromBlock(buffer, mPayloads[index].mData, size);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.load(std::memory_order_relaxed) != value) {
+        return DequeueResult::Contended; // Overwritten while copying
+    }
+    return DequeueResult::Success;
+}
+
+// DequeueBatch function: Claims the run of ready blocks at the tail with one CAS and copies them out.
+// The run stops at the first block that is not ready, at maxCount (at most kMaxBatch) and at the end of the
+// ring, so it never spans two laps.
+// Parameters:
+// - buffers: maxCount consecutive 64-byte buffers.
+// - sizes: receives the size of each dequeued block.
+// - maxCount: maximum number of blocks to dequeue.
+// Returns:
+// - the number of blocks dequeued. Blocks the producer overwrote while they were being copied are dropped and
+//   the intact ones moved up to fill the gap, so fewer blocks than were claimed can be returned.
+size_t SoASPMCQueue::dequeueBatch(uint8_t* buffers, size_t* sizes, size_t maxCount) {
+    size_t localTail = mTail.load(std::memory_order_relaxed);
+    size_t index = localTail % mCapacity;
+    uint64_t expected = readySequence(localTail / mCapacity);
+
+    if (maxCount > kMaxBatch) {
+        maxCount = kMaxBatch;
+    }
+    if (maxCount > mCapacity - index) {
+        maxCount = mCapacity - index;
+    }
+    size_t count = readyRun(index, expected, maxCount);
+    if (count == 0) {
+        if (maxCount > 0 && blockSequence(header(index).load(std::memory_order_relaxed)) > expected) {
+            skipOverwritten(localTail);
+        }
+        return 0;
+    }
+    // Makes the payloads published before the headers seen by the scan visible
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (!mTail.compare_exchange_strong(localTail, localTail + count, std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    return copyClaimed(localTail, count, buffers, sizes);
+}
+
+// CopyClaimed function: Copies out a run of blocks the caller has claimed, keeping only the ones that still
+// hold the claimed lap. A producer lapping the ring after the scan can leave a block being rewritten (its
+// header carries the writing sequence and no size) or already published for the next lap, whose payload this
+// consumer has no acquire ordering for and which will be dequeued again at its own position; both are skipped.
+// Parameters:
+// - position: tail position of the first claimed block.
+// - count: number of claimed blocks, all within one lap.
+// - buffers: count consecutive 64-byte buffers.
+// - sizes: receives the size of each block copied.
+// Returns:
+// - the number of blocks copied, packed at the front of buffers and sizes.
+size_t SoASPMCQueue::copyClaimed(size_t position, size_t count, uint8_t* buffers, size_t* sizes) {
+    size_t index = position % mCapacity;
+    uint64_t expected = readySequence(position / mCapacity);
+
+    uint64_t values[kMaxBatch];
+    size_t offsets[kMaxBatch];
+    size_t copied = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t value = header(index + i).load(std::memory_order_relaxed);
+        if (blockSequence(value) != expected) {
+            continue; // Overwritten since the scan
+        }
+        values[copied] = value;
+        offsets[copied] = i;
+        sizes[copied] = blockSize(value);
+        copyFromBlock(buffers + copied * kBlockPayloadSize, mPayloads[index + i].mData, sizes[copied]);
+        ++copied;
+    }
+
+    // Drop the blocks the producer started rewriting during the copy, keeping the rest in order
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t kept = 0;
+    for (size_t i = 0; i < copied; ++i) {
+        if (header(index + offsets[i]).load(std::memory_order_relaxed) != values[i]) {
+            continue;
+        }
+        if (kept != i) {
+            std::memcpy(buffers + kept * kBlockPayloadSize, buffers + i * kBlockPayloadSize, sizes[i]);
+            sizes[kept] = sizes[i];
+        }
+        ++kept;
+    }
+    return kept;
+}
+
+size_t SoASPMCQueue::depth() const {
+    size_t tail = mTail.load(std::memory_order_relaxed);
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t depth = head > tail ? head - tail : 0;
+    return depth < mCapacity ? depth : mCapacity;
+}
+
+std::atomic<uint64_t>& SoASPMCQueue::header(size_t index) const {
+    return mHeaderLines[index / kHeadersPerLine].mHeaders[index % kHeadersPerLine];
+}
+
+// ReadyRun function: Counts consecutive headers from `index` that carry `sequence`, up to maxCount.
+// The loads are relaxed; the caller issues an acquire fence before touching payloads. With AVX2, aligned
+// groups of four headers are compared at once. Each 8-byte lane of the vector load is naturally aligned, so
+// every header is still read whole; a run cut short by a header changing mid-scan is simply shorter.
+size_t SoASPMCQueue::readyRun(size_t index, uint64_t sequence, size_t maxCount) const {
+    size_t count = 0;
+    auto ready = [&](size_t offset) {
+        return blockSequence(header(index + offset).load(std::memory_order_relaxed)) == sequence;
+    };
+#if defined(__AVX2__)
+    // Scalar up to a group boundary, so that each vector load stays inside one header line
+    while (count < maxCount && (index + count) % 4 != 0) {
+        if (!ready(count)) {
+            return count;
+        }
+        ++count;
+    }
+    const __m256i wanted = _mm256_set1_epi64x(static_cast<long long>(sequence));
+    while (count + 4 <= maxCount) {
+        const void* group = &header(index + count);
+        __m256i values = _mm256_load_si256(static_cast<const __m256i*>(group));
+        __m256i equal = _mm256_cmpeq_epi64(_mm256_srli_epi64(values, kBlockSizeBits), wanted);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(equal));
+        if (mask != 0xF) {
+            return count + static_cast<size_t>(countTrailingZeros(~static_cast<unsigned int>(mask)));
+        }
+        count += 4;
+    }
+#endif
+    while (count < maxCount && ready(count)) {
+        ++count;
+    }
+    return count;
+}
+
+// SkipOverwritten function: Moves the tail past blocks the producer has already overwritten.
+void SoASPMCQueue::skipOverwritten(size_t localTail) {
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t oldest = head > mCapacity ? head - mCapacity : 0;
+    if (oldest > localTail) {
+        mTail.compare_exchange_strong(localTail, oldest, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef SOA_QUEUE_H
+#define SOA_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "spmc_queue.h"
+
+// Structure-of-arrays variant of SPMCQueue.
+// The block headers (same packed sequence/size word and lap protocol as Block) live in a dense array,
+// eight per cache line, and the payloads in a separate array of 64-byte lines. A consumer looking for ready
+// blocks only reads header lines, and only touches the payload lines of blocks it has claimed. That pays
+// off in dequeueBatch(), which scans a run of consecutive ready headers (four per AVX2 compare where
+// available) and claims the whole run with a single CAS on mTail.
+class SoASPMCQueue {
+public:
+    static constexpr size_t kMaxBatch = 64;
+
+    SoASPMCQueue(size_t capacity);
+    ~SoASPMCQueue();
+
+    SoASPMCQueue(const SoASPMCQueue&) = delete;
+    SoASPMCQueue& operator=(const SoASPMCQueue&) = delete;
+
+    bool enqueue(const uint8_t* data, size_t size);
+
+    bool dequeue(uint8_t* buffer, size_t& size);
+
+    DequeueResult tryDequeue(uint8_t* buffer, size_t& size);
+
+    // Dequeues up to maxCount (at most kMaxBatch) consecutive blocks with one claim. The i-th block returned is
+    // copied to buffers + 64 * i and its size stored in sizes[i]; blocks overwritten during the copy are left
+    // out. Returns the number of blocks dequeued, 0 if none was ready or another consumer claimed them first.
+    size_t dequeueBatch(uint8_t* buffers, size_t* sizes, size_t maxCount);
+
+    size_t depth() const;
+
+private:
+    friend class SoASPMCQueueLapTest; // Laps the ring between a batch's claim and its copy
+
+    static constexpr size_t kHeadersPerLine = 8;
+
+    struct alignas(64) HeaderLine {
+        std::atomic<uint64_t> mHeaders[kHeadersPerLine];
+    };
+
+    struct alignas(64) Payload {
+        uint8_t mData[64];
+    };
+
+    std::atomic<uint64_t>& header(size_t index) const;
+    size_t readyRun(size_t index, uint64_t sequence, size_t maxCount) const;
+    size_t copyClaimed(size_t position, size_t count, uint8_t* buffers, size_t* sizes);
+    void skipOverwritten(size_t localTail);
+
+    size_t mCapacity;
+    std::unique_ptr<HeaderLine[]> mHeaderLines;
+    std::unique_ptr<Payload[]> mPayloads;
+    alignas(64) std::atomic<size_t> mHead; // Next position to write, never wrapped
+    alignas(64) std::atomic<size_t> mTail; // Next position to read, never wrapped
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "spmc_cursor.h"
+#include "block_copy.h"
+
+// Constructor for SPMCCursor.
+// Parameters:
+// - queue: queue to follow; it must outlive the cursor.
+SPMCCursor::SPMCCursor(const SPMCQueue& queue) : mQueue(queue), mPosition(0), mFiltered(false) {
+    seekEnd();
+}
+
+void SPMCCursor::seekLatest() {
+    uint64_t end = endSequence();
+    mPosition = end > 0 ? end - 1 : 0;
+}
+
+void SPMCCursor::seekOldest() {
+    mPosition = oldestSequence();
+}
+
+void SPMCCursor::seekEnd() {
+    mPosition = endSequence();
+}
+
+// Seek function: Positions the cursor at a sequence number, e.g. one checkpointed before a restart.
+// Parameters:
+// - sequence: ring position to read next; may be ahead of the producer.
+// Returns:
+// - true if the cursor moved, false if that block has already been overwritten.
+bool SPMCCursor::seek(uint64_t sequence) {
+    if (sequence < oldestSequence()) {
+        return false;
+    }
+    mPosition = sequence;
+    return true;
+}
+
+// SeekTimestamp function: Binary searches the retained blocks for the first one stamped at or after a time.
+// A block overwritten while the search probes it is older than everything still in the ring, so the search
+// treats it as too early and carries on above it.
+// Parameters:
+// - timestampNs: time in nanoseconds on the producer's clock.
+// Returns:
+// - true if the cursor is at the first block at or after the time, false if it landed on the oldest block
+//   and older ones, which may have matched too, were already overwritten.
+bool SPMCCursor::seekTimestamp(uint64_t timestampNs) {
+    uint64_t oldest = oldestSequence();
+    uint64_t low = oldest;
+    uint64_t high = endSequence();
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        uint64_t stamp = 0;
+        if (!timestampAt(middle, stamp) || stamp < timestampNs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    mPosition = low;
+    return !(low == oldest && oldest > 0);
+}
+
+void SPMCCursor::subscribe(const TopicSet& topics) {
+    mTopics = topics;
+    mFiltered = true;
+}
+
+void SPMCCursor::subscribeAll() {
+    mFiltered = false;
+}
+
+// Read function: Copies the next block at or after the cursor's position without claiming it, skipping the
+// blocks whose topic is not subscribed.
+// Parameters:
+// - buffer: pointer to the buffer where the data will be copied.
+// - size: reference to a variable to store the size of the data.
+// Returns:
+// - Success if data was copied, Empty if the block is not published yet, Contended if the producer
+//   overwrote it first.
+DequeueResult SPMCCursor::read(uint8_t* buffer, size_t& size) {
+    while (true) {
+        const Block& block = mQueue.mQueue[mPosition % mQueue.mCapacity];
+        uint64_t expected = readySequence(mPosition / mQueue.mCapacity);
+
+        uint64_t header = block.mHeader.load(std::memory_order_acquire);
+        if (blockSequence(header) != expected) {
+            if (blockSequence(header) < expected) {
+                return DequeueResult::Empty;
+            }
+            seekOldest();
+            return DequeueResult::Contended;
+        }
+
+        bool wanted = !mFiltered || mTopics.contains(block.mTopic.load(std::memory_order_relaxed));
+        if (wanted) {
+            size = blockSize(header);
+            copyFromBlock(buffer, block.mData, size);
+        }
+
+        // Same seqlock check as SPMCQueue::tryDequeue: a header that moved on means the copy, or the topic
+        // the block was skipped for, may be torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block.mHeader.load(std::memory_order_relaxed) != header) {
+            seekOldest();
+            return DequeueResult::Contended;
+        }
+
+        ++mPosition;
+        if (wanted) {
+            return DequeueResult::Success;
+        }
+    }
+}
+
+// TimestampAt function: Reads the publish time of the block at a sequence number. A block whose header is not
+// visible yet is the newest in the ring and reads as UINT64_MAX.
+// Returns:
+// - false if the block has already been overwritten.
+bool SPMCCursor::timestampAt(uint64_t sequence, uint64_t& timestampNs) const {
+    const Block& block = mQueue.mQueue[sequence % mQueue.mCapacity];
+    uint64_t expected = readySequence(sequence / mQueue.mCapacity);
+    uint64_t header = block.mHeader.load(std::memory_order_acquire);
+    if (blockSequence(header) != expected) {
+        timestampNs = UINT64_MAX;
+        return blockSequence(header) < expected;
+    }
+    timestampNs = block.mTimestampNs.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return block.mHeader.load(std::memory_order_relaxed) == header;
+}
+
+uint64_t SPMCCursor::position() const {
+    return mPosition;
+}
+
+// OldestSequence function: Returns the oldest position the producer has not started overwriting. The block at
+// head - capacity may be rewritten at any moment, so it is already considered gone.
+uint64_t SPMCCursor::oldestSequence() const {
+    uint64_t head = mQueue.mHead.load(std::memory_order_relaxed);
+    return head >= mQueue.mCapacity ? head - mQueue.mCapacity + 1 : 0;
+}
+
+uint64_t SPMCCursor::endSequence() const {
+    return mQueue.mHead.load(std::memory_order_relaxed);
+}
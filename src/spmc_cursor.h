@@ -0,0 +1,81 @@
+#ifndef SPMC_CURSOR_H
+#define SPMC_CURSOR_H
+
+#include <chrono>
+#include <cstdint>
+#include "spmc_queue.h"
+#include "topic_set.h"
+
+// Private read position over an SPMCQueue, for consumers that need to choose where they join the stream.
+//
+// A cursor reads blocks without claiming them: it never touches mTail, so it sees every block whatever the
+// regular consumers do, and any number of cursors can follow one queue. Ring positions are monotonic and
+// double as sequence numbers; position p lives at index p % capacity with the lap p / capacity encoded in
+// the block header, so seeking to a sequence is O(1) and a read can tell whether the block still holds it.
+// A cursor the producer laps skips to the oldest block still in the ring.
+//
+// A cursor is owned by one thread. Saving position() and passing it to seek() later resumes the stream
+// where it stopped, as long as the producer has not overwritten that block in the meantime.
+//
+// A cursor can subscribe to a set of topics. read() then steps over blocks tagged with other topics using
+// only the header line (the header, topic and a re-check of the header), without copying their payload.
+class SPMCCursor {
+public:
+    // Starts at the next block the producer publishes.
+    explicit SPMCCursor(const SPMCQueue& queue);
+
+    // Moves to the most recently published block, or to the start of an empty queue.
+    void seekLatest();
+
+    // Moves to the oldest block still in the ring.
+    void seekOldest();
+
+    // Moves to the next block the producer publishes, skipping everything already in the ring.
+    void seekEnd();
+
+    // Moves to the given sequence number. Returns false, leaving the cursor where it was, if the producer
+    // has already overwritten that block.
+    bool seek(uint64_t sequence);
+
+    // Moves to the first block stamped at or after `timestampNs` (see SPMCQueue::enqueue with a timestamp),
+    // by binary search over the ring, or to seekEnd() if every block is older. Returns false if the ring may
+    // no longer reach back that far: the search landed on the oldest block and older ones were overwritten.
+    bool seekTimestamp(uint64_t timestampNs);
+
+    // seekTimestamp for a time point on the clock the producer stamps blocks with.
+    template <typename Clock, typename Duration>
+    bool seek(std::chrono::time_point<Clock, Duration> time) {
+        return seekTimestamp(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count()));
+    }
+
+    // Only returns blocks tagged with one of `topics` from now on.
+    void subscribe(const TopicSet& topics);
+
+    // Returns every block again.
+    void subscribeAll();
+
+    // Copies the block at position() and advances past it. With a subscription, first steps over the
+    // blocks whose topic is not subscribed.
+    // Returns:
+    // - Success if the block was copied, Empty if it is not published yet, Contended if the producer
+    //   lapped the cursor, which then moves to the oldest block still in the ring.
+    DequeueResult read(uint8_t* buffer, size_t& size);
+
+    // Sequence number read() returns next.
+    uint64_t position() const;
+
+    // Range of sequence numbers currently readable: [oldestSequence(), endSequence()).
+    uint64_t oldestSequence() const;
+    uint64_t endSequence() const;
+
+private:
+    bool timestampAt(uint64_t sequence, uint64_t& timestampNs) const;
+
+    const SPMCQueue& mQueue;
+    uint64_t mPosition;
+    bool mFiltered;
+    TopicSet mTopics;
+};
+
+#endif
@@ -1,15 +1,93 @@
 #include "spmc_queue.h"
 #include <iostream>
-#include <cstring>
+#include "block_copy.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Whether the CPU implements PREFETCHW (CPUID 0x80000001, ECX bit 8). Builds with -mprfchw (or a -march that
+// includes it) get it from the compiler; other x86 builds check once at startup and emit it by hand.
+bool detectPrefetchw() {
+#if defined(__PRFCHW__)
+    return true;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(0x80000001u, &eax, &ebx, &ecx, &edx) && (ecx & (1u << 8)) != 0;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int registers[4];
+    __cpuid(registers, 0x80000000);
+    if (static_cast<unsigned int>(registers[0]) < 0x80000001u) {
+        return false;
+    }
+    __cpuid(registers, 0x80000001);
+    return (registers[2] & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+const bool kHasPrefetchw = detectPrefetchw();
+
+inline void prefetchForRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+// Fetches the line in exclusive state. Without -mprfchw GCC and Clang lower a write prefetch to prefetcht0,
+// which only gets a shared copy, so PREFETCHW is emitted directly when the CPU has it.
+inline void prefetchForWrite(const void* address) {
+#if defined(__PRFCHW__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_prefetch(address, 1, 3);
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    if (kHasPrefetchw) {
+        __asm__ __volatile__("prefetchw %0" : : "m"(*static_cast<const char*>(address)));
+    } else {
+        __builtin_prefetch(address, 0, 3);
+    }
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    if (kHasPrefetchw) {
+        _m_prefetchw(address);
+    } else {
+        _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+    }
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 1, 3);
+#else
+    (void)address;
+#endif
+}
+
+} // namespace
 
 // Constructor for SPMCQueue.
-// Initializes the queue with a given capacity, setting the head and tail pointers to 0.
-// Allocates memory for the queue blocks and initializes the version and size of each block.
-SPMCQueue::SPMCQueue(size_t capacity) : mCapacity(capacity), mHead(0), mTail(0) {
+// Initializes the queue with a given capacity, setting the head and tail positions to 0.
+// Allocates memory for the queue blocks and marks every block as never written.
+// Parameters:
+// - capacity: number of blocks in the ring.
+// - storeMode: whether enqueue writes payloads through the cache or with non-temporal stores.
+// - prefetchDistance: how many blocks ahead the producer prefetches for writing and consumers prefetch for
+//   reading, so the coherence miss on an upcoming block overlaps with the current one. 0 disables it;
+//   values of the capacity or more are clamped. The best distance depends on the machine, see
+//   benchmark_queue --prefetch.
+SPMCQueue::SPMCQueue(size_t capacity, StoreMode storeMode, size_t prefetchDistance)
+        : mCapacity(capacity), mStoreMode(storeMode),
+          mPrefetchDistance(prefetchDistance < capacity ? prefetchDistance : (capacity > 0 ? capacity - 1 : 0)),
+          mHead(0), mTail(0) {
     mQueue = new Block[capacity];
     for (size_t i = 0; i < capacity; ++i) {
-        mQueue[i].mVersion.store(0);
-        mQueue[i].mSize.store(0);
+        mQueue[i].mHeader.store(0);
+        mQueue[i].mTimestampNs.store(0);
+        mQueue[i].mTopic.store(0);
     }
 }
 
@@ -25,17 +103,51 @@ SPMCQueue::~SPMCQueue() {
 // Returns:
 // - true if the data was successfully enqueued.
 bool SPMCQueue::enqueue(const uint8_t* data, size_t size) {
-    Block& block = mQueue[mHead % mCapacity]; // Get the block at the head position
-    size_t version = block.mVersion.load(std::memory_order_acquire); // Get the current version of the block
+    return enqueue(data, size, 0);
+}
+
+// Enqueue function: Adds a block of data stamped with its publish time and tagged with a topic.
+// Parameters:
+// - data: pointer to the data to be enqueued.
+// - size: size of the data to be enqueued.
+// - timestampNs: publish time in nanoseconds on the producer's clock, not lower than the previous block's,
+//   or 0 for none.
+// - topic: topic tag, below kMaxTopics to be matched by a subscription.
+// Returns:
+// - true if the data was successfully enqueued.
+bool SPMCQueue::enqueue(const uint8_t* data, size_t size, uint64_t timestampNs, uint32_t topic) {
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t index = head % mCapacity;
+    Block& block = mQueue[index]; // Get the block at the head position
+    uint64_t lap = head / mCapacity;
+
+    if (mPrefetchDistance != 0) {
+        prefetchBlock(index, true);
+    }
+
+    // Published but never claimed by a consumer
+    SPMC_STATS(if (head >= mCapacity && mTail.load(std::memory_order_relaxed) <= head - mCapacity) bumpStat(mOverwrites));
+
+    // Mark the block as being written first, so a consumer still copying the previous lap notices
+    block.mHeader.store(packBlockHeader(writingSequence(lap), 0), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
 
-    block.mVersion.store(1, std::memory_order_release);
+    if (mStoreMode == StoreMode::NonTemporal) {
+        // Streaming stores are not ordered with other stores, so fence on both sides of them
+        streamFence();
+        streamToBlock(block.mData, data, size);
+        streamFence();
+    } else {
+        copyToBlock(block.mData, data, size);
+    }
+    block.mTimestampNs.store(timestampNs, std::memory_order_relaxed);
+    block.mTopic.store(topic, std::memory_order_relaxed);
 
-    std::memcpy(block.mData, data, size);
-    block.mSize.store(size, std::memory_order_release);
+    block.mHeader.store(packBlockHeader(readySequence(lap), size), std::memory_order_release);
 
-    block.mVersion.fetch_add(1, std::memory_order_release);
+    mHead.store(head + 1, std::memory_order_relaxed);
 
-    mHead = (mHead + 1) % mCapacity;
+    SPMC_STATS(bumpStat(mPublished));
 
     return true;
 }
@@ -47,24 +159,187 @@ bool SPMCQueue::enqueue(const uint8_t* data, size_t size) {
 // Returns:
 // - true if data was successfully dequeued, false if the block is not ready to be read.
 bool SPMCQueue::dequeue(uint8_t* buffer, size_t& size) {
-    size_t localTail = mTail;
-    Block& block = mQueue[localTail % mCapacity];
-    size_t version = block.mVersion.load(std::memory_order_acquire);
+    return tryDequeue(buffer, size) == DequeueResult::Success;
+}
 
-    // Check if the block is still being written to (odd version) or if it hasn't been written to yet (version == 0)
-    if (version % 2 == 1 || version == 0) {
-        return false; // Cannot dequeue if the block is not ready
+// TryDequeue function: Same as dequeue, but reports why an attempt failed.
+// Parameters:
+// - buffer: pointer to the buffer where the data will be copied.
+// - size: reference to a variable to store the size of the dequeued data.
+// Returns:
+// - Success if data was dequeued, Empty if the block is not ready to be read,
+//   Contended if another consumer claimed the block first.
+DequeueResult SPMCQueue::tryDequeue(uint8_t* buffer, size_t& size) {
+    size_t localTail = mTail.load(std::memory_order_relaxed);
+    size_t index = localTail % mCapacity;
+    Block& block = mQueue[index];
+    uint64_t expected = readySequence(localTail / mCapacity);
+
+    if (mPrefetchDistance != 0) {
+        prefetchBlock(index, false);
     }
 
-    if (!std::atomic_compare_exchange_strong(&mTail, &localTail, (localTail + 1) % mCapacity)) {
-        return false;
+    uint64_t header = block.mHeader.load(std::memory_order_acquire);
+
+    // The block is ready only if it carries exactly this lap's sequence. An older or odd sequence means it
+    // has not been published yet; a newer one means the producer lapped the consumers.
+    if (blockSequence(header) != expected) {
+        if (blockSequence(header) < expected) {
+            return DequeueResult::Empty; // Cannot dequeue if the block is not ready
+        }
+        skipOverwritten(localTail);
+        return DequeueResult::Contended;
     }
 
-    size = block.mSize.load(std::memory_order_acquire);
+    if (!mTail.compare_exchange_strong(localTail, localTail + 1, std::memory_order_relaxed)) {
+        SPMC_STATS(size_t shard = statsShardIndex());
+        SPMC_STATS(bumpShardStat(mShards[shard].mContentionRetries, shard));
+        return DequeueResult::Contended;
+    }
 
-    std::memcpy(buffer, block.mData, size);
+    size = blockSize(header);
 
-    block.mVersion.fetch_add(2, std::memory_order_release);
+    copyFromBlock(buffer, block.mData, size);
 
-    return true;
+    // The producer only rewrites this block after lapping the ring; if it did so during the copy, the
+    // header has moved on and the copy may be torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (block.mHeader.load(std::memory_order_relaxed) != header) {
+        return DequeueResult::Contended;
+    }
+
+    SPMC_STATS(size_t shard = statsShardIndex());
+    SPMC_STATS(bumpShardStat(mShards[shard].mConsumed, shard));
+
+    return DequeueResult::Success;
+}
+
+// DequeueBatch function: Claims the run of ready blocks at the tail with a single CAS and copies them out.
+// The run is found like drain's and stops at the first block that is not ready, at maxCount and at the end
+// of the ring. Each block is checked again after its copy; the producer overwrites in ring order, so a
+// block lost to it is dropped and the intact blocks after it are still returned, packed to the front.
+// Parameters:
+// - buffers: maxCount consecutive 64-byte buffers.
+// - sizes: receives the size of each dequeued block.
+// - maxCount: maximum number of blocks to dequeue.
+// Returns:
+// - the number of blocks copied to buffers[0..n); 0 if none was ready or another consumer claimed the run.
+size_t SPMCQueue::dequeueBatch(uint8_t* buffers, size_t* sizes, size_t maxCount) {
+    size_t localTail = mTail.load(std::memory_order_relaxed);
+    size_t index = localTail % mCapacity;
+    uint64_t expected = readySequence(localTail / mCapacity);
+    if (maxCount > mCapacity - index) {
+        maxCount = mCapacity - index;
+    }
+
+    size_t count = 0;
+    while (count < maxCount
+           && blockSequence(mQueue[index + count].mHeader.load(std::memory_order_acquire)) == expected) {
+        ++count;
+    }
+    if (count == 0) {
+        if (maxCount > 0 && blockSequence(mQueue[index].mHeader.load(std::memory_order_relaxed)) > expected) {
+            skipOverwritten(localTail);
+        }
+        return 0;
+    }
+
+    if (!mTail.compare_exchange_strong(localTail, localTail + count, std::memory_order_relaxed)) {
+        SPMC_STATS(size_t shard = statsShardIndex());
+        SPMC_STATS(bumpShardStat(mShards[shard].mContentionRetries, shard));
+        return 0;
+    }
+
+    size_t copied = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Block& block = mQueue[index + i];
+        uint64_t header = block.mHeader.load(std::memory_order_relaxed); // Acquired by the scan
+        if (blockSequence(header) != expected) {
+            continue; // Overwritten since the scan
+        }
+        sizes[copied] = blockSize(header);
+        copyFromBlock(buffers + copied * kBlockPayloadSize, block.mData, sizes[copied]);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block.mHeader.load(std::memory_order_relaxed) == header) {
+            ++copied;
+        }
+    }
+
+    SPMC_STATS(size_t shard = statsShardIndex());
+    SPMC_STATS(bumpShardStat(mShards[shard].mConsumed, shard, copied));
+
+    return copied;
+}
+
+// SkipOverwritten function: Moves the tail past blocks the producer has already overwritten, to the oldest
+// block still in the ring. Another consumer may have moved the tail already, in which case this is a no-op.
+void SPMCQueue::skipOverwritten(size_t localTail) {
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t oldest = head > mCapacity ? head - mCapacity : 0;
+    if (oldest > localTail) {
+        mTail.compare_exchange_strong(localTail, oldest, std::memory_order_relaxed);
+    }
+}
+
+// PrefetchBlock function: Prefetches both cache lines of the block mPrefetchDistance positions after `index`.
+// Parameters:
+// - index: ring index of the block being accessed now.
+// - forWrite: true on the producer side, so the lines are fetched in exclusive state (PREFETCHW on x86 CPUs
+//   that have it, a read prefetch on those that do not) and the store does not need a second ownership request.
+void SPMCQueue::prefetchBlock(size_t index, bool forWrite) const {
+    size_t ahead = index + mPrefetchDistance;
+    if (ahead >= mCapacity) {
+        ahead -= mCapacity;
+    }
+    const Block& block = mQueue[ahead];
+    if (forWrite) {
+        prefetchForWrite(&block.mHeader);
+        prefetchForWrite(block.mData);
+    } else {
+        prefetchForRead(&block.mHeader);
+        prefetchForRead(block.mData);
+    }
+}
+
+// Depth function: Number of published blocks not yet claimed by a consumer, capped at the capacity once the
+// producer has lapped the consumers. Reads the head and tail positions with two relaxed loads.
+size_t SPMCQueue::depth() const {
+    size_t tail = mTail.load(std::memory_order_relaxed);
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t depth = head > tail ? head - tail : 0;
+    return depth < mCapacity ? depth : mCapacity;
+}
+
+// Stats function: Takes a snapshot of the queue's statistics.
+// Returns:
+// - the current depth and, when built with SPMC_ENABLE_STATS, the publish, overwrite, consume and
+//   contention counters, including a per-consumer breakdown. Safe to call from any thread.
+QueueStats SPMCQueue::stats() const {
+    QueueStats snapshot;
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t tail = mTail.load(std::memory_order_relaxed);
+    snapshot.mCapacity = mCapacity;
+    snapshot.mHead = head;
+    snapshot.mTail = tail;
+    snapshot.mDepth = depth();
+
+#ifdef SPMC_ENABLE_STATS
+    snapshot.mEnabled = true;
+    snapshot.mPublished = mPublished.load(std::memory_order_relaxed);
+    snapshot.mOverwrites = mOverwrites.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kStatsMaxShards; ++i) {
+        ConsumerStats consumer;
+        consumer.mShard = i;
+        consumer.mConsumed = mShards[i].mConsumed.load(std::memory_order_relaxed);
+        consumer.mContentionRetries = mShards[i].mContentionRetries.load(std::memory_order_relaxed);
+        if (consumer.mConsumed == 0 && consumer.mContentionRetries == 0) {
+            continue;
+        }
+        snapshot.mConsumed += consumer.mConsumed;
+        snapshot.mContentionRetries += consumer.mContentionRetries;
+        snapshot.mConsumers.push_back(consumer);
+    }
+#endif
+
+    return snapshot;
 }
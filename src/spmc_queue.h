@@ -4,27 +4,178 @@
 #include <atomic>
 #include <cstdint>
 #include <iostream>
+#include "spmc_stats.h"
+
+// Block header: one 64-bit word holding the block's sequence in the high bits and the payload size in the
+// low kBlockSizeBits. For ring position p on lap L = p / capacity the producer stores sequence 2L + 1 while
+// it writes the block and 2L + 2 once it is published; 0 means never written. A block is therefore
+// published with one release store and read with one acquire load, and a consumer can tell from the
+// sequence alone whether the block holds the lap it expects.
+//
+// The optional publish timestamp and topic share the header's cache line, which the producer writes anyway,
+// and are covered by the same header checks as the payload.
+constexpr unsigned kBlockSizeBits = 16;
 
 struct Block {
-    std::atomic<size_t> mVersion;  // Local block version
-    std::atomic<size_t> mSize;     // Size of the data
-    alignas(64) uint8_t mData[64]; // Data buffer (64 bytes)
+    std::atomic<uint64_t> mHeader;      // Sequence and payload size, see above
+    std::atomic<uint64_t> mTimestampNs; // Publish time in nanoseconds, 0 if not stamped
+    std::atomic<uint32_t> mTopic;       // Topic tag for filtering cursors (topic_set.h), 0 if not tagged
+    alignas(64) uint8_t mData[64];      // Data buffer (64 bytes)
 };
 
+inline uint64_t packBlockHeader(uint64_t sequence, size_t size) {
+    return (sequence << kBlockSizeBits) | static_cast<uint64_t>(size);
+}
+
+inline uint64_t blockSequence(uint64_t header) {
+    return header >> kBlockSizeBits;
+}
+
+inline size_t blockSize(uint64_t header) {
+    return static_cast<size_t>(header & ((uint64_t{1} << kBlockSizeBits) - 1));
+}
+
+inline uint64_t writingSequence(uint64_t lap) {
+    return 2 * lap + 1;
+}
+
+inline uint64_t readySequence(uint64_t lap) {
+    return 2 * lap + 2;
+}
+
+// Outcome of a single dequeue attempt.
+// - Success: a block was claimed and copied out.
+// - Empty: the block at the tail is not ready to be read.
+// - Contended: the block was ready but another consumer claimed it first (failed CAS on mTail), or the
+//   producer lapped the consumers and overwrote it; retrying moves on to the next block.
+enum class DequeueResult {
+    Success,
+    Empty,
+    Contended
+};
+
+// How enqueue writes a payload into its block.
+// - Cached: regular stores through the producer's cache.
+// - NonTemporal: streaming stores that bypass the cache, for rings much larger than the cache where
+//   every block written would otherwise evict part of the producer's working set. Each enqueue then
+//   pays two sfence instructions, so this only pays off for large rings.
+enum class StoreMode {
+    Cached,
+    NonTemporal
+};
+
+// Memory ordering contract. Only the block header synchronises data; every other atomic is bookkeeping.
+// - Producer: marks the block as being written with a relaxed header store followed by a release fence,
+//   copies the payload, then publishes with a release store of the header. No RMW and no seq_cst store, so
+//   on x86-64 enqueue compiles to plain moves (checked by the spmc_fence_check test).
+// - Consumer: an acquire load of the header makes the payload visible. After copying, an acquire fence and
+//   a relaxed reload of the header detect an overwrite that raced with the copy (the seqlock read pattern).
+// - mHead is written only by the producer, so its relaxed load there is a plain read of its own value; the
+//   relaxed store only feeds depth() and the skip past overwritten blocks, neither of which reads data.
+// - mTail arbitrates which consumer owns a position. Its load and CAS are relaxed because ownership is all
+//   it conveys; the one locked instruction left per dequeue is that CAS.
 class SPMCQueue {
 public:
-    SPMCQueue(size_t capacity);
+    SPMCQueue(size_t capacity, StoreMode storeMode = StoreMode::Cached, size_t prefetchDistance = 0);
     ~SPMCQueue();
 
     bool enqueue(const uint8_t* data, size_t size);
 
+    // Same as enqueue, stamping the block with a publish time for SPMCCursor::seek(time_point) and tagging
+    // it with a topic for SPMCCursor::subscribe. Timestamps must not decrease from one block to the next;
+    // pass 0 to leave a block unstamped. Blocks enqueued without a topic carry topic 0.
+    bool enqueue(const uint8_t* data, size_t size, uint64_t timestampNs, uint32_t topic = 0);
+
     bool dequeue(uint8_t* buffer, size_t& size);
 
+    DequeueResult tryDequeue(uint8_t* buffer, size_t& size);
+
+    // Claims the run of ready blocks at the tail with one CAS and copies them into consecutive 64-byte
+    // buffers. Returns the number of blocks copied.
+    size_t dequeueBatch(uint8_t* buffers, size_t* sizes, size_t maxCount);
+
+    // Claims the run of ready blocks at the tail with one CAS and hands each to fn(const uint8_t* data,
+    // size_t size) in place, in order. See the definition below for the limits of a run.
+    template <typename F>
+    size_t drain(F&& fn, size_t maxCount = SIZE_MAX);
+
+    size_t depth() const;
+
+    QueueStats stats() const;
+
 private:
+    friend class SPMCCursor;
+
+    void skipOverwritten(size_t localTail);
+    void prefetchBlock(size_t index, bool forWrite) const;
+
     size_t mCapacity;
-    std::atomic<size_t> mHead;
-    std::atomic<size_t> mTail;
+    StoreMode mStoreMode;
+    size_t mPrefetchDistance; // Blocks ahead of head/tail to prefetch, 0 to disable
+    std::atomic<size_t> mHead; // Next position to write, never wrapped
+    std::atomic<size_t> mTail; // Next position to read, never wrapped
     Block* mQueue;
+
+#ifdef SPMC_ENABLE_STATS
+    // Producer-owned counters, kept off the consumers' lines
+    alignas(64) std::atomic<uint64_t> mPublished{0};
+    std::atomic<uint64_t> mOverwrites{0};
+    StatsShard mShards[kStatsMaxShards];
+#endif
 };
 
+// Drain function: Consumes every contiguously ready block at the tail in one go, Disruptor style.
+// The run is found with one acquire load per header and claimed with a single CAS on mTail, then each block is
+// passed to the handler straight from the ring, without a copy. The run stops at the first block that is not
+// ready, at maxCount and at the end of the ring, so a full ring takes two calls.
+// The handler reads the block in place, so the producer must not lap the ring while it runs; a block found
+// overwritten before its handler is called ends the drain and is not counted.
+// Parameters:
+// - fn: handler called as fn(const uint8_t* data, size_t size) for each block.
+// - maxCount: maximum number of blocks to consume.
+// Returns:
+// - the number of blocks handed to fn; 0 if none was ready or another consumer claimed the run first.
+template <typename F>
+size_t SPMCQueue::drain(F&& fn, size_t maxCount) {
+    size_t localTail = mTail.load(std::memory_order_relaxed);
+    size_t index = localTail % mCapacity;
+    uint64_t expected = readySequence(localTail / mCapacity);
+    if (maxCount > mCapacity - index) {
+        maxCount = mCapacity - index;
+    }
+
+    size_t count = 0;
+    while (count < maxCount
+           && blockSequence(mQueue[index + count].mHeader.load(std::memory_order_acquire)) == expected) {
+        ++count;
+    }
+    if (count == 0) {
+        if (maxCount > 0 && blockSequence(mQueue[index].mHeader.load(std::memory_order_relaxed)) > expected) {
+            skipOverwritten(localTail);
+        }
+        return 0;
+    }
+
+    if (!mTail.compare_exchange_strong(localTail, localTail + count, std::memory_order_relaxed)) {
+        SPMC_STATS(size_t shard = statsShardIndex());
+        SPMC_STATS(bumpShardStat(mShards[shard].mContentionRetries, shard));
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const Block& block = mQueue[index + i];
+        uint64_t header = block.mHeader.load(std::memory_order_relaxed); // Acquired by the scan
+        if (blockSequence(header) != expected) {
+            count = i; // Overwritten since the scan
+            break;
+        }
+        fn(static_cast<const uint8_t*>(block.mData), blockSize(header));
+    }
+
+    SPMC_STATS(size_t shard = statsShardIndex());
+    SPMC_STATS(bumpShardStat(mShards[shard].mConsumed, shard, count));
+
+    return count;
+}
+
 #endif
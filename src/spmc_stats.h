@@ -0,0 +1,75 @@
+#ifndef SPMC_STATS_H
+#define SPMC_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "thread_slot.h"
+
+// Optional SPMCQueue statistics, enabled by defining SPMC_ENABLE_STATS (CMake option of the same name).
+// When disabled, the SPMC_STATS() hooks compile away and SPMCQueue::stats() only reports the depth.
+//
+// Counters that consumers update are sharded per thread: every thread leases its own cache-line-padded
+// StatsShard, so an increment is a relaxed load and store on a line nobody else writes, never a locked
+// RMW. Reading stats() sums the shards.
+
+#ifdef SPMC_ENABLE_STATS
+#define SPMC_STATS(statement) statement
+#else
+#define SPMC_STATS(statement)
+#endif
+
+// Number of shards per queue, one per thread slot. The last shard is shared by every thread that could
+// not lease a slot of its own and is the only one updated with fetch_add.
+constexpr size_t kStatsMaxShards = kMaxThreadSlots;
+constexpr size_t kStatsSharedShard = kSharedThreadSlot;
+
+// Counters owned by one consumer thread.
+struct alignas(64) StatsShard {
+    std::atomic<uint64_t> mConsumed{0};
+    std::atomic<uint64_t> mContentionRetries{0};
+};
+
+// Per-consumer counters in a QueueStats snapshot. mShard identifies the consumer thread's shard.
+struct ConsumerStats {
+    size_t mShard = 0;
+    uint64_t mConsumed = 0;
+    uint64_t mContentionRetries = 0;
+};
+
+// Snapshot returned by SPMCQueue::stats(). Counters are read without stopping the queue, so they are
+// individually exact but not a single consistent cut.
+struct QueueStats {
+    bool mEnabled = false;                 // false when built without SPMC_ENABLE_STATS
+    size_t mCapacity = 0;                  // number of blocks in the ring
+    size_t mHead = 0;                      // next position the producer writes (never wrapped)
+    size_t mTail = 0;                      // next position a consumer reads (never wrapped)
+    size_t mDepth = 0;                     // blocks published but not yet consumed or overwritten
+    uint64_t mPublished = 0;               // successful enqueue calls
+    uint64_t mOverwrites = 0;              // unread blocks overwritten by the producer
+    uint64_t mConsumed = 0;                // successful dequeue calls, all consumers
+    uint64_t mContentionRetries = 0;       // dequeue attempts that lost the CAS on mTail, all consumers
+    std::vector<ConsumerStats> mConsumers; // one entry per shard that has seen any activity
+};
+
+// Increments a counter that only the calling thread writes.
+inline void bumpStat(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Increments a shard counter, falling back to an atomic RMW on the shared shard.
+inline void bumpShardStat(std::atomic<uint64_t>& counter, size_t shard, uint64_t amount = 1) {
+    if (shard == kStatsSharedShard) {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    } else {
+        bumpStat(counter, amount);
+    }
+}
+
+// Shard index of the calling thread.
+inline size_t statsShardIndex() {
+    return threadSlotIndex();
+}
+
+#endif
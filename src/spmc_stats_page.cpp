@@ -0,0 +1,210 @@
+#include "spmc_stats_page.h"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+std::string shmPath(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+std::runtime_error shmError(const std::string& what, const std::string& name) {
+    return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+}
+
+uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+// Constructor for StatsPagePublisher.
+// Creates the shared-memory page and initialises its header. Nothing is readable until the first publish().
+// The page is created exclusively: two publishers sharing one seqlocked page would corrupt each other's
+// snapshots, so an existing page, live or left behind by a crashed publisher, is an error. Remove a stale
+// page with removeStatsPage() first.
+StatsPagePublisher::StatsPagePublisher(const SPMCQueue& queue, const std::string& name)
+        : mQueue(queue), mName(shmPath(name)), mPage(nullptr), mRunning(false) {
+    int fd = shm_open(mName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw shmError("shm_open", mName);
+    }
+    if (ftruncate(fd, sizeof(StatsPageLayout)) != 0) {
+        close(fd);
+        shm_unlink(mName.c_str());
+        throw shmError("ftruncate", mName);
+    }
+    void* memory = mmap(nullptr, sizeof(StatsPageLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(mName.c_str());
+        throw shmError("mmap", mName);
+    }
+
+    std::memset(memory, 0, sizeof(StatsPageLayout));
+    mPage = new (memory) StatsPageLayout();
+    mPage->mVersion = kStatsPageVersion;
+    // Readers check the magic last, so it goes in once the rest of the header is valid
+    std::atomic_thread_fence(std::memory_order_release);
+    mPage->mMagic = kStatsPageMagic;
+}
+
+// RemoveStatsPage function: Removes the page /<name>, e.g. one left behind by a publisher that crashed.
+// Returns:
+// - true if a page was removed.
+bool removeStatsPage(const std::string& name) {
+    return shm_unlink(shmPath(name).c_str()) == 0;
+}
+
+// Destructor for StatsPagePublisher.
+// Stops the background thread and removes the page; attached readers keep their mapping until they detach.
+StatsPagePublisher::~StatsPagePublisher() {
+    stop();
+    munmap(mPage, sizeof(StatsPageLayout));
+    shm_unlink(mName.c_str());
+}
+
+// Publish function: Writes the queue's current statistics into the page under the seqlock.
+void StatsPagePublisher::publish() {
+    QueueStats stats = mQueue.stats();
+
+    uint64_t sequence = mPage->mSequence.load(std::memory_order_relaxed);
+    mPage->mSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    mPage->mTimestampNs.store(steadyNowNs(), std::memory_order_relaxed);
+    mPage->mEnabled.store(stats.mEnabled, std::memory_order_relaxed);
+    mPage->mCapacity.store(stats.mCapacity, std::memory_order_relaxed);
+    mPage->mHead.store(stats.mHead, std::memory_order_relaxed);
+    mPage->mTail.store(stats.mTail, std::memory_order_relaxed);
+    mPage->mDepth.store(stats.mDepth, std::memory_order_relaxed);
+    mPage->mPublished.store(stats.mPublished, std::memory_order_relaxed);
+    mPage->mOverwrites.store(stats.mOverwrites, std::memory_order_relaxed);
+    mPage->mConsumed.store(stats.mConsumed, std::memory_order_relaxed);
+    mPage->mContentionRetries.store(stats.mContentionRetries, std::memory_order_relaxed);
+
+    size_t count = stats.mConsumers.size() < kStatsMaxShards ? stats.mConsumers.size() : kStatsMaxShards;
+    mPage->mConsumerCount.store(count, std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        mPage->mConsumers[i].mShard.store(stats.mConsumers[i].mShard, std::memory_order_relaxed);
+        mPage->mConsumers[i].mConsumed.store(stats.mConsumers[i].mConsumed, std::memory_order_relaxed);
+        mPage->mConsumers[i].mContentionRetries.store(stats.mConsumers[i].mContentionRetries,
+                                                      std::memory_order_relaxed);
+    }
+
+    mPage->mSequence.store(sequence + 2, std::memory_order_release);
+}
+
+// Start function: Publishes periodically from a background thread.
+// Parameters:
+// - interval: time between two snapshots.
+void StatsPagePublisher::start(std::chrono::milliseconds interval) {
+    if (mRunning.exchange(true)) {
+        return;
+    }
+    mThread = std::thread([this, interval]() {
+        while (mRunning.load(std::memory_order_relaxed)) {
+            publish();
+            std::this_thread::sleep_for(interval);
+        }
+    });
+}
+
+// Stop function: Stops the background thread, if any, after a final snapshot.
+void StatsPagePublisher::stop() {
+    if (!mRunning.exchange(false)) {
+        return;
+    }
+    mThread.join();
+    publish();
+}
+
+// Constructor for StatsPageReader.
+// Maps an existing page read-only and validates its header.
+StatsPageReader::StatsPageReader(const std::string& name) : mPage(nullptr) {
+    std::string path = shmPath(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw shmError("shm_open", path);
+    }
+    // Mapping past the end of the object would fault on the first read, e.g. when attaching between the
+    // publisher's shm_open and ftruncate, or to an unrelated object of the same name
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw shmError("fstat", path);
+    }
+    if (static_cast<size_t>(info.st_size) < sizeof(StatsPageLayout)) {
+        close(fd);
+        throw std::runtime_error(path + " is not a compatible SPMCQueue stats page");
+    }
+    void* memory = mmap(nullptr, sizeof(StatsPageLayout), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        throw shmError("mmap", path);
+    }
+
+    mPage = static_cast<const StatsPageLayout*>(memory);
+    uint64_t magic = mPage->mMagic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (magic != kStatsPageMagic || mPage->mVersion != kStatsPageVersion) {
+        munmap(memory, sizeof(StatsPageLayout));
+        throw std::runtime_error(path + " is not a compatible SPMCQueue stats page");
+    }
+}
+
+// Destructor for StatsPageReader.
+StatsPageReader::~StatsPageReader() {
+    munmap(const_cast<StatsPageLayout*>(mPage), sizeof(StatsPageLayout));
+}
+
+// Read function: Copies a consistent snapshot out of the page, retrying while the publisher is writing.
+// Parameters:
+// - stats: receives the snapshot.
+// - timestampNs: receives the steady_clock time at which the snapshot was taken.
+// Returns:
+// - true if a snapshot was read, false if nothing has been published yet.
+bool StatsPageReader::read(QueueStats& stats, uint64_t& timestampNs) const {
+    while (true) {
+        uint64_t before = mPage->mSequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;
+        }
+        if (before % 2 == 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        timestampNs = mPage->mTimestampNs.load(std::memory_order_relaxed);
+        stats.mEnabled = mPage->mEnabled.load(std::memory_order_relaxed) != 0;
+        stats.mCapacity = mPage->mCapacity.load(std::memory_order_relaxed);
+        stats.mHead = mPage->mHead.load(std::memory_order_relaxed);
+        stats.mTail = mPage->mTail.load(std::memory_order_relaxed);
+        stats.mDepth = mPage->mDepth.load(std::memory_order_relaxed);
+        stats.mPublished = mPage->mPublished.load(std::memory_order_relaxed);
+        stats.mOverwrites = mPage->mOverwrites.load(std::memory_order_relaxed);
+        stats.mConsumed = mPage->mConsumed.load(std::memory_order_relaxed);
+        stats.mContentionRetries = mPage->mContentionRetries.load(std::memory_order_relaxed);
+
+        size_t count = mPage->mConsumerCount.load(std::memory_order_relaxed);
+        stats.mConsumers.resize(count < kStatsMaxShards ? count : kStatsMaxShards);
+        for (size_t i = 0; i < stats.mConsumers.size(); ++i) {
+            stats.mConsumers[i].mShard = mPage->mConsumers[i].mShard.load(std::memory_order_relaxed);
+            stats.mConsumers[i].mConsumed = mPage->mConsumers[i].mConsumed.load(std::memory_order_relaxed);
+            stats.mConsumers[i].mContentionRetries =
+                    mPage->mConsumers[i].mContentionRetries.load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (mPage->mSequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef SPMC_STATS_PAGE_H
+#define SPMC_STATS_PAGE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "spmc_queue.h"
+
+// Shared-memory page holding a queue's latest statistics, for out-of-process inspection (see tools/spmc_top).
+//
+// The page is written only by StatsPagePublisher, from its own thread, using a seqlock: the sequence is odd
+// while a snapshot is being written. Readers map the page read-only and retry until they see the same even
+// sequence before and after copying, so inspecting a queue never takes a lock or writes to a line the
+// producer or consumers touch. POSIX only (shm_open/mmap).
+
+constexpr uint64_t kStatsPageMagic = 0x53504d4353544154ull; // "SPMCSTAT"
+constexpr uint32_t kStatsPageVersion = 1;
+
+struct StatsPageConsumer {
+    std::atomic<uint64_t> mShard;
+    std::atomic<uint64_t> mConsumed;
+    std::atomic<uint64_t> mContentionRetries;
+};
+
+// Layout of the shared page. Every field is an atomic so that concurrent reads are well defined.
+struct StatsPageLayout {
+    uint64_t mMagic;
+    uint32_t mVersion;
+    uint32_t mReserved;
+    alignas(64) std::atomic<uint64_t> mSequence;
+    std::atomic<uint64_t> mTimestampNs;      // steady_clock time of the snapshot
+    std::atomic<uint64_t> mEnabled;
+    std::atomic<uint64_t> mCapacity;
+    std::atomic<uint64_t> mHead;
+    std::atomic<uint64_t> mTail;
+    std::atomic<uint64_t> mDepth;
+    std::atomic<uint64_t> mPublished;
+    std::atomic<uint64_t> mOverwrites;
+    std::atomic<uint64_t> mConsumed;
+    std::atomic<uint64_t> mContentionRetries;
+    std::atomic<uint64_t> mConsumerCount;
+    StatsPageConsumer mConsumers[kStatsMaxShards];
+};
+
+// Writes snapshots of a queue's statistics into a named shared-memory page.
+class StatsPagePublisher {
+public:
+    // Creates the page /<name>. Throws std::runtime_error if it cannot be created or already exists.
+    StatsPagePublisher(const SPMCQueue& queue, const std::string& name);
+    ~StatsPagePublisher();
+
+    StatsPagePublisher(const StatsPagePublisher&) = delete;
+    StatsPagePublisher& operator=(const StatsPagePublisher&) = delete;
+
+    // Copies the current stats() snapshot into the page.
+    void publish();
+
+    // Publishes every `interval` from a background thread until stop() or destruction.
+    void start(std::chrono::milliseconds interval);
+    void stop();
+
+private:
+    const SPMCQueue& mQueue;
+    std::string mName;
+    StatsPageLayout* mPage;
+    std::atomic<bool> mRunning;
+    std::thread mThread;
+};
+
+// Removes the page /<name>, e.g. one left behind by a publisher that crashed. Returns false if there is none.
+bool removeStatsPage(const std::string& name);
+
+// Read-only view of a page written by StatsPagePublisher, usable from another process.
+class StatsPageReader {
+public:
+    // Maps the page /<name> read-only. Throws std::runtime_error if it does not exist, is smaller than a
+    // stats page or does not carry the stats page magic.
+    explicit StatsPageReader(const std::string& name);
+    ~StatsPageReader();
+
+    StatsPageReader(const StatsPageReader&) = delete;
+    StatsPageReader& operator=(const StatsPageReader&) = delete;
+
+    // Copies a consistent snapshot out of the page.
+    // Returns:
+    // - false if no snapshot has been published yet.
+    bool read(QueueStats& stats, uint64_t& timestampNs) const;
+
+private:
+    const StatsPageLayout* mPage;
+};
+
+#endif
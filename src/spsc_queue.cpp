@@ -0,0 +1,80 @@
+#include "spsc_queue.h"
+#include "block_copy.h"
+
+// Constructor for SPSCQueue.
+// Parameters:
+// - capacity: number of blocks the ring can hold before enqueue returns false.
+SPSCQueue::SPSCQueue(size_t capacity)
+        : mSlotCount(capacity + 1), mHead(0), mTailCached(0), mTail(0), mHeadCached(0), mLocalTail(0),
+          mUnpublished(0) {
+    mSlots = new Slot[mSlotCount];
+}
+
+// Destructor for SPSCQueue.
+SPSCQueue::~SPSCQueue() {
+    delete[] mSlots;
+}
+
+// Enqueue function: Adds a block of data to the queue. Producer thread only.
+// Parameters:
+// - data: pointer to the data to be enqueued.
+// - size: size of the data to be enqueued.
+// Returns:
+// - true if the data was enqueued, false if the ring is full.
+bool SPSCQueue::enqueue(const uint8_t* data, size_t size) {
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t next = head + 1 == mSlotCount ? 0 : head + 1;
+    if (next == mTailCached) {
+        mTailCached = mTail.load(std::memory_order_acquire);
+        if (next == mTailCached) {
+            return false;
+        }
+    }
+
+    Slot& slot = mSlots[head];
+    copyToBlock(slot.mData, data, size);
+    slot.mSize = size;
+
+    mHead.store(next, std::memory_order_release);
+    return true;
+}
+
+// Dequeue function: Retrieves a block of data from the queue. Consumer thread only.
+// Parameters:
+// - buffer: pointer to the buffer where the data will be copied.
+// - size: reference to a variable to store the size of the dequeued data.
+// Returns:
+// - true if data was dequeued, false if the ring is empty.
+bool SPSCQueue::dequeue(uint8_t* buffer, size_t& size) {
+    size_t tail = mLocalTail;
+    if (tail == mHeadCached) {
+        mHeadCached = mHead.load(std::memory_order_acquire);
+        if (tail == mHeadCached) {
+            // Going idle: hand back everything read so far so the producer never waits on a batch
+            publishTail();
+            return false;
+        }
+    }
+
+    Slot& slot = mSlots[tail];
+    size = slot.mSize;
+    copyFromBlock(buffer, slot.mData, size);
+
+    mLocalTail = tail + 1 == mSlotCount ? 0 : tail + 1;
+    if (++mUnpublished == kPublishBatch) {
+        publishTail();
+    }
+    return true;
+}
+
+size_t SPSCQueue::capacity() const {
+    return mSlotCount - 1;
+}
+
+// PublishTail function: Makes the consumer's progress visible to the producer.
+void SPSCQueue::publishTail() {
+    if (mUnpublished != 0) {
+        mTail.store(mLocalTail, std::memory_order_release);
+        mUnpublished = 0;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include "spmc_queue.h"
+
+// Single-producer single-consumer ring for streams that only ever have one reader.
+// With one consumer there is nothing to arbitrate, so the consumer owns its index outright: no CAS on the
+// tail and no version RMW per block. Each side publishes its index with a release store and keeps a cached
+// copy of the other side's index, re-reading it only when the cache says the ring is full (producer) or
+// empty (consumer), in the style of Lamport's queue with Rigtorp's cached indices. The consumer also
+// batches its index, publishing it every kPublishBatch blocks or when it finds the ring empty.
+//
+// Unlike SPMCQueue, enqueue never overwrites: it returns false when the ring is full.
+class SPSCQueue {
+public:
+    static constexpr size_t kPublishBatch = 16;
+
+    SPSCQueue(size_t capacity);
+    ~SPSCQueue();
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    bool enqueue(const uint8_t* data, size_t size);
+
+    bool dequeue(uint8_t* buffer, size_t& size);
+
+    size_t capacity() const;
+
+private:
+    struct Slot {
+        size_t mSize;
+        alignas(64) uint8_t mData[64];
+    };
+
+    void publishTail();
+
+    size_t mSlotCount; // capacity + 1, one slot always stays free to tell full from empty
+    Slot* mSlots;
+
+    // Producer side
+    alignas(64) std::atomic<size_t> mHead;
+    size_t mTailCached;
+
+    // Consumer side
+    alignas(64) std::atomic<size_t> mTail;
+    size_t mHeadCached;
+    size_t mLocalTail;   // next slot to read; mTail lags it by up to kPublishBatch
+    size_t mUnpublished; // blocks read since mTail was last stored
+};
+
+// Ring type for a consumer count known at compile time: SPSCQueue for one consumer, SPMCQueue otherwise.
+template <size_t Consumers>
+using SPMCQueueFor = std::conditional_t<Consumers == 1, SPSCQueue, SPMCQueue>;
+
+#endif
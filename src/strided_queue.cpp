@@ -0,0 +1,110 @@
+#include "strided_queue.h"
+#include <stdexcept>
+#include "block_copy.h"
+
+// Constructor for StridedSPMCQueue.
+// Parameters:
+// - capacity: number of blocks in the ring, a multiple of `consumers`.
+// - consumers: number of consumers; consumer i is created with StridedConsumer(queue, i).
+StridedSPMCQueue::StridedSPMCQueue(size_t capacity, size_t consumers)
+        : mCapacity(capacity), mConsumers(consumers), mQueue(nullptr), mHead(0), mHeadSlot(0), mHeadLap(0),
+          mHeadOwner(0) {
+    if (consumers == 0 || capacity == 0 || capacity % consumers != 0) {
+        throw std::invalid_argument("StridedSPMCQueue capacity must be a non-zero multiple of the consumer count");
+    }
+
+    mQueue = new Block[capacity];
+    for (size_t i = 0; i < capacity; ++i) {
+        mQueue[i].mHeader.store(0);
+    }
+    mCursors.reset(new ConsumerCursor[consumers]);
+    mCachedCursors.reset(new uint64_t[consumers]);
+    for (size_t i = 0; i < consumers; ++i) {
+        mCursors[i].mPosition.store(i, std::memory_order_relaxed);
+        mCachedCursors[i] = i;
+    }
+}
+
+// Destructor for StridedSPMCQueue.
+StridedSPMCQueue::~StridedSPMCQueue() {
+    delete[] mQueue;
+}
+
+// Enqueue function: Adds a block of data to the queue. Single producer only.
+// Parameters:
+// - data: pointer to the data to be enqueued.
+// - size: size of the data to be enqueued.
+// Returns:
+// - true if the data was enqueued, false if the consumer owning the next slot has not read it yet.
+bool StridedSPMCQueue::enqueue(const uint8_t* data, size_t size) {
+    // The slot last held position mHead - capacity, owned by the same consumer. Only re-read that
+    // consumer's cursor when the cached value says it is still unread.
+    uint64_t& cached = mCachedCursors[mHeadOwner];
+    if (cached + mCapacity <= mHead) {
+        cached = mCursors[mHeadOwner].mPosition.load(std::memory_order_acquire);
+        if (cached + mCapacity <= mHead) {
+            return false;
+        }
+    }
+
+    Block& block = mQueue[mHeadSlot];
+    copyToBlock(block.mData, data, size);
+    block.mHeader.store(packBlockHeader(readySequence(mHeadLap), size), std::memory_order_release);
+
+    ++mHead;
+    if (++mHeadSlot == mCapacity) {
+        mHeadSlot = 0;
+        ++mHeadLap;
+    }
+    if (++mHeadOwner == mConsumers) {
+        mHeadOwner = 0;
+    }
+    return true;
+}
+
+size_t StridedSPMCQueue::capacity() const {
+    return mCapacity;
+}
+
+size_t StridedSPMCQueue::consumerCount() const {
+    return mConsumers;
+}
+
+// Constructor for StridedConsumer.
+// Parameters:
+// - queue: the queue to consume from.
+// - index: this consumer's partition, in [0, queue.consumerCount()). Each index must have one consumer.
+StridedConsumer::StridedConsumer(StridedSPMCQueue& queue, size_t index)
+        : mQueue(queue), mCursor(queue.mCursors[index % queue.mConsumers]),
+          mPosition(mCursor.mPosition.load(std::memory_order_relaxed)),
+          mSlot(static_cast<size_t>(mPosition % queue.mCapacity)),
+          mLap(static_cast<size_t>(mPosition / queue.mCapacity)) {
+}
+
+// Dequeue function: Retrieves this consumer's next block.
+// Parameters:
+// - buffer: pointer to the buffer where the data will be copied.
+// - size: reference to a variable to store the size of the dequeued data.
+// Returns:
+// - true if data was dequeued, false if the producer has not published this consumer's next block yet.
+bool StridedConsumer::dequeue(uint8_t* buffer, size_t& size) {
+    Block& block = mQueue.mQueue[mSlot];
+    uint64_t header = block.mHeader.load(std::memory_order_acquire);
+    if (blockSequence(header) != readySequence(mLap)) {
+        return false;
+    }
+
+    size = blockSize(header);
+    copyFromBlock(buffer, block.mData, size);
+
+    mPosition += mQueue.mConsumers;
+    mSlot += mQueue.mConsumers;
+    if (mSlot >= mQueue.mCapacity) {
+        mSlot -= mQueue.mCapacity;
+        ++mLap;
+    }
+
+    // Hands the slot back to the producer; a plain store on a line only this consumer writes
+    mCursor.mPosition.store(mPosition, std::memory_order_release);
+    return true;
+}
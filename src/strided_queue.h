@@ -0,0 +1,71 @@
+#ifndef STRIDED_QUEUE_H
+#define STRIDED_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "spmc_queue.h"
+
+// Static stride partitioning for a fixed set of N equally fast consumers.
+// Consumer i owns ring positions i, i + N, i + 2N... and never touches a shared tail: it waits for its
+// next block's header to carry that lap's ready sequence, copies the block and publishes
+// its own position on a private cache line. A steady-state dequeue is one acquire load, the copy and one
+// release store, with no read-modify-write at all.
+//
+// The trade-offs come with the static split: messages are dealt round-robin whatever each consumer's
+// speed, and the producer can only be `capacity` positions ahead of the slowest consumer, so a stalled
+// consumer makes enqueue return false once the producer reaches that consumer's next slot. Blocks are
+// never overwritten. The capacity must be a multiple of the consumer count, so that every slot belongs to
+// the same consumer on every lap.
+class StridedSPMCQueue {
+public:
+    // Throws std::invalid_argument if consumers is 0 or capacity is not a non-zero multiple of it.
+    StridedSPMCQueue(size_t capacity, size_t consumers);
+    ~StridedSPMCQueue();
+
+    StridedSPMCQueue(const StridedSPMCQueue&) = delete;
+    StridedSPMCQueue& operator=(const StridedSPMCQueue&) = delete;
+
+    bool enqueue(const uint8_t* data, size_t size);
+
+    size_t capacity() const;
+
+    size_t consumerCount() const;
+
+private:
+    friend class StridedConsumer;
+
+    // Next position consumer i will read, written only by that consumer
+    struct alignas(64) ConsumerCursor {
+        std::atomic<uint64_t> mPosition{0};
+    };
+
+    size_t mCapacity;
+    size_t mConsumers;
+    Block* mQueue;
+    std::unique_ptr<ConsumerCursor[]> mCursors;
+
+    // Producer-owned state
+    alignas(64) uint64_t mHead;      // next position to write, never wrapped
+    size_t mHeadSlot;                // mHead % mCapacity
+    size_t mHeadLap;                 // mHead / mCapacity
+    size_t mHeadOwner;               // mHead % mConsumers
+    std::unique_ptr<uint64_t[]> mCachedCursors; // last cursor value seen per consumer
+};
+
+// Consumer handle for one partition of a StridedSPMCQueue, owned by one consumer thread.
+class StridedConsumer {
+public:
+    StridedConsumer(StridedSPMCQueue& queue, size_t index);
+
+    bool dequeue(uint8_t* buffer, size_t& size);
+
+private:
+    StridedSPMCQueue& mQueue;
+    StridedSPMCQueue::ConsumerCursor& mCursor;
+    uint64_t mPosition; // next position to read
+    size_t mSlot;       // mPosition % capacity
+    size_t mLap;        // mPosition / capacity
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef THREAD_SLOT_H
+#define THREAD_SLOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Small per-thread indices for structures that keep one cache line per thread (stats shards,
+// flat-combining publication slots). Each live thread leases a private index below kSharedThreadSlot;
+// once all of them are taken, further threads get kSharedThreadSlot and must not assume exclusivity.
+constexpr size_t kMaxThreadSlots = 64;
+constexpr size_t kSharedThreadSlot = kMaxThreadSlots - 1;
+
+// Bitmap of slot indices currently leased by live threads.
+inline std::atomic<uint64_t> gLeasedThreadSlots{0};
+
+// A thread's claim on a slot index, released when the thread exits so the index can be reused.
+class ThreadSlotLease {
+public:
+    ThreadSlotLease() {
+        const uint64_t leasable = (uint64_t(1) << kSharedThreadSlot) - 1;
+        uint64_t leased = gLeasedThreadSlots.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t available = ~leased & leasable;
+            if (available == 0) {
+                return; // Every private slot is taken; use the shared one
+            }
+            size_t index = 0;
+            while ((available & (uint64_t(1) << index)) == 0) {
+                ++index;
+            }
+            // Acquire pairs with the release in the destructor: the previous holder's last plain
+            // load+store on its slot's counters happens-before this thread's first one
+            if (gLeasedThreadSlots.compare_exchange_weak(leased, leased | (uint64_t(1) << index),
+                                                         std::memory_order_acquire, std::memory_order_relaxed)) {
+                mIndex = index;
+                return;
+            }
+        }
+    }
+
+    ~ThreadSlotLease() {
+        if (mIndex != kSharedThreadSlot) {
+            gLeasedThreadSlots.fetch_and(~(uint64_t(1) << mIndex), std::memory_order_release);
+        }
+    }
+
+    ThreadSlotLease(const ThreadSlotLease&) = delete;
+    ThreadSlotLease& operator=(const ThreadSlotLease&) = delete;
+
+    size_t index() const {
+        return mIndex;
+    }
+
+private:
+    size_t mIndex = kSharedThreadSlot;
+};
+
+// Slot index of the calling thread, leased on first use.
+inline size_t threadSlotIndex() {
+    thread_local ThreadSlotLease lease;
+    return lease.index();
+}
+
+#endif
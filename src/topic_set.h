@@ -0,0 +1,36 @@
+#ifndef TOPIC_SET_H
+#define TOPIC_SET_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Topics a block can be tagged with (see SPMCQueue::enqueue). Map instruments or feeds onto topic numbers
+// below kMaxTopics; blocks enqueued without a topic carry topic 0.
+constexpr size_t kMaxTopics = 1024;
+
+// Subscription bitmap over the topics, two cache lines. contains() is a shift, a mask and one load, so a
+// cursor can reject a block from its header line alone.
+class TopicSet {
+public:
+    // Adds a topic; topics of kMaxTopics or more are ignored.
+    void add(uint32_t topic) {
+        if (topic < kMaxTopics) {
+            mWords[topic / 64] |= uint64_t{1} << (topic % 64);
+        }
+    }
+
+    void remove(uint32_t topic) {
+        if (topic < kMaxTopics) {
+            mWords[topic / 64] &= ~(uint64_t{1} << (topic % 64));
+        }
+    }
+
+    bool contains(uint32_t topic) const {
+        return topic < kMaxTopics && (mWords[topic / 64] >> (topic % 64) & 1) != 0;
+    }
+
+private:
+    alignas(64) uint64_t mWords[kMaxTopics / 64] = {};
+};
+
+#endif
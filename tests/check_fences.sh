@@ -0,0 +1,32 @@
+#!/bin/sh
+# Fails if any of the given functions contains a full fence or a locked instruction once compiled.
+# Usage: check_fences.sh <objdump> <object-file> <function>...
+# <function> is the demangled name up to the opening parenthesis, e.g. "SPMCQueue::enqueue".
+set -u
+
+objdump="$1"
+object="$2"
+shift 2
+
+status=0
+for function in "$@"; do
+    body=$("$objdump" -d -C --no-show-raw-insn "$object" \
+           | awk -v name="<$function(" 'index($0, name) && /^[0-9a-f]+ </ { inside = 1; next }
+                                        inside && /^$/ { exit }
+                                        inside { print }')
+    if [ -z "$body" ]; then
+        echo "$function: not found in $object"
+        status=1
+        continue
+    fi
+    # Only xchg with a memory operand is implicitly locked; xchg %ax,%ax is alignment padding
+    fences=$(printf '%s\n' "$body" | grep -E 'mfence|xchg[^(]*\(|lock ' || true)
+    if [ -n "$fences" ]; then
+        echo "$function: unexpected fence or locked instruction"
+        printf '%s\n' "$fences"
+        status=1
+    else
+        echo "$function: no fence or locked instruction"
+    fi
+done
+exit $status
@@ -0,0 +1,93 @@
+#include "../src/conflating_queue.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <thread>
+#include <vector>
+
+// Test case for a burst of updates conflating into one read per key, carrying the latest value.
+TEST(ConflatingQueueTest, BurstConflatesToLatest) {
+    ConflatingQueue queue(16);
+    for (uint64_t round = 0; round < 100; ++round) {
+        for (uint64_t key = 1; key <= 3; ++key) {
+            uint64_t value = key * 1000 + round;
+            ASSERT_TRUE(queue.enqueue(key, reinterpret_cast<const uint8_t*>(&value), sizeof(value)));
+        }
+    }
+    EXPECT_EQ(queue.keyCount(), 3u);
+    EXPECT_EQ(queue.pending(), 3u);
+
+    std::map<uint64_t, uint64_t> latest;
+    uint64_t key = 0;
+    uint8_t buffer[64];
+    size_t size = 0;
+    while (queue.dequeue(key, buffer, size)) {
+        EXPECT_EQ(size, sizeof(uint64_t));
+        EXPECT_EQ(latest.count(key), 0u); // Each key is read once
+        latest[key] = *reinterpret_cast<uint64_t*>(buffer);
+    }
+    ASSERT_EQ(latest.size(), 3u);
+    EXPECT_EQ(latest[1], 1099u);
+    EXPECT_EQ(latest[2], 2099u);
+    EXPECT_EQ(latest[3], 3099u);
+
+    // A key read once is queued again by its next update
+    uint64_t value = 7;
+    ASSERT_TRUE(queue.enqueue(2, reinterpret_cast<const uint8_t*>(&value), sizeof(value)));
+    ASSERT_TRUE(queue.dequeue(key, buffer, size));
+    EXPECT_EQ(key, 2u);
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 7u);
+    EXPECT_FALSE(queue.dequeue(key, buffer, size));
+}
+
+// Test case for refusing new keys once the table holds maxKeys of them.
+TEST(ConflatingQueueTest, RejectsKeysBeyondCapacity) {
+    ConflatingQueue queue(4);
+    uint8_t value = 1;
+    for (uint64_t key = 0; key < 4; ++key) {
+        EXPECT_TRUE(queue.enqueue(key, &value, 1));
+    }
+    EXPECT_FALSE(queue.enqueue(99, &value, 1));
+    EXPECT_TRUE(queue.enqueue(2, &value, 1)); // Known keys still update
+}
+
+// Test case for a consumer racing the producer: values per key never go backwards, and once the producer
+// stops the consumer ends up with every key's final value.
+TEST(ConflatingQueueTest, ConsumerSeesFinalValues) {
+    const uint64_t numKeys = 64;
+    const uint64_t rounds = 2000;
+    ConflatingQueue queue(numKeys);
+
+    std::atomic<bool> done{false};
+    std::vector<uint64_t> latest(numKeys, 0);
+    bool monotonic = true;
+    std::thread consumer([&]() {
+        uint64_t key = 0;
+        uint8_t buffer[64];
+        size_t size = 0;
+        while (true) {
+            bool finished = done.load(std::memory_order_acquire);
+            if (queue.dequeue(key, buffer, size)) {
+                uint64_t value = *reinterpret_cast<uint64_t*>(buffer);
+                monotonic = monotonic && value >= latest[key];
+                latest[key] = value;
+            } else if (finished) {
+                break;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (uint64_t round = 1; round <= rounds; ++round) {
+        for (uint64_t key = 0; key < numKeys; ++key) {
+            queue.enqueue(key, reinterpret_cast<const uint8_t*>(&round), sizeof(round));
+        }
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    EXPECT_TRUE(monotonic);
+    for (uint64_t key = 0; key < numKeys; ++key) {
+        EXPECT_EQ(latest[key], rounds);
+    }
+}
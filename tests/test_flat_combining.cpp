@@ -0,0 +1,62 @@
+#include "../src/flat_combining_producer.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Test case for a single publisher going through the combiner.
+TEST(FlatCombiningProducerTest, SinglePublisher) {
+    SPMCQueue queue(10);
+    FlatCombiningProducer producer(queue);
+
+    uint8_t data[64];
+    std::memset(data, 42, sizeof(data));
+    EXPECT_TRUE(producer.publish(data, sizeof(data)));
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_TRUE(queue.dequeue(buffer, size));
+    EXPECT_EQ(size, sizeof(data));
+    EXPECT_EQ(buffer[0], 42);
+}
+
+// Test case for many threads publishing concurrently through one combiner.
+// The ring holds every message, so each value must be enqueued exactly once.
+TEST(FlatCombiningProducerTest, ManyPublishersDeliverEveryMessageOnce) {
+    const int numPublishers = 8;
+    const int perPublisher = 200;
+    SPMCQueue queue(numPublishers * perPublisher);
+    FlatCombiningProducer producer(queue);
+
+    auto publisher = [&producer](int id) {
+        for (int i = 0; i < perPublisher; ++i) {
+            uint32_t value = id * perPublisher + i;
+            uint8_t data[64];
+            std::memset(data, 0, sizeof(data));
+            std::memcpy(data, &value, sizeof(value));
+            EXPECT_TRUE(producer.publish(data, sizeof(data)));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numPublishers; ++i) {
+        threads.emplace_back(publisher, i);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::vector<int> seen(numPublishers * perPublisher, 0);
+    uint8_t buffer[64];
+    size_t size = 0;
+    while (queue.dequeue(buffer, size)) {
+        uint32_t value = 0;
+        std::memcpy(&value, buffer, sizeof(value));
+        ASSERT_LT(value, seen.size());
+        ++seen[value];
+    }
+    for (int count : seen) {
+        EXPECT_EQ(count, 1);
+    }
+}
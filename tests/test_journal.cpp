@@ -0,0 +1,247 @@
+#include "../src/journal.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Fresh journal directory per test, removed with its segments when the test ends.
+class JournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/spmc_journal_XXXXXX";
+        ASSERT_NE(mkdtemp(path), nullptr);
+        mDirectory = path;
+    }
+
+    void TearDown() override {
+        for (uint64_t segment : listJournalSegments(mDirectory)) {
+            unlink((mDirectory + "/" + journalSegmentName(segment)).c_str());
+        }
+        rmdir(mDirectory.c_str());
+    }
+
+    std::string mDirectory;
+};
+
+// Test case for the segment file names round-tripping through the parser.
+TEST_F(JournalTest, SegmentNames) {
+    uint64_t segment = 0;
+    EXPECT_TRUE(parseJournalSegmentName(journalSegmentName(0x1234abcd), segment));
+    EXPECT_EQ(segment, 0x1234abcdu);
+    EXPECT_FALSE(parseJournalSegmentName("notes.txt", segment));
+}
+
+// Test case for appending across several segments and reading every message back by sequence and in order.
+TEST_F(JournalTest, AppendAndReadAcrossSegments) {
+    JournalWriter writer(mDirectory, 8, 0);
+    for (uint64_t i = 0; i < 50; ++i) {
+        EXPECT_EQ(writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i)), i);
+    }
+
+    JournalReader reader(mDirectory);
+    EXPECT_EQ(reader.slotsPerSegment(), 8u);
+    uint8_t buffer[64];
+    size_t size = 0;
+    for (uint64_t i = 0; i < 50; ++i) {
+        ASSERT_TRUE(reader.next(buffer, size));
+        EXPECT_EQ(size, sizeof(i));
+        EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), i);
+    }
+    EXPECT_FALSE(reader.next(buffer, size)); // Not written yet
+    EXPECT_EQ(reader.position(), 50u);
+
+    ASSERT_TRUE(reader.read(17, buffer, size));
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 17u);
+}
+
+// Test case for a writer reopening an existing journal and continuing after its last record.
+TEST_F(JournalTest, WriterContinuesExistingJournal) {
+    {
+        JournalWriter writer(mDirectory, 8, 0);
+        for (uint64_t i = 0; i < 13; ++i) {
+            writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+        }
+    }
+    JournalWriter writer(mDirectory, 1024, 0);
+    EXPECT_EQ(writer.slotsPerSegment(), 8u); // The journal keeps its segment size
+    EXPECT_EQ(writer.nextSequence(), 13u);
+    uint64_t value = 13;
+    EXPECT_EQ(writer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(value)), 13u);
+}
+
+// Test case for reopening a journal whose writer crashed while creating a segment: the unfinished file, empty
+// or sized but without its magic, is discarded instead of making the journal unusable.
+TEST_F(JournalTest, WriterDiscardsUnfinishedSegment) {
+    {
+        JournalWriter writer(mDirectory, 8, 0);
+        for (uint64_t i = 0; i < 5; ++i) {
+            writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+        }
+    }
+    std::string prepared = mDirectory + "/" + journalSegmentName(1);
+    int fd = open(prepared.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    {
+        JournalWriter writer(mDirectory, 8, 0);
+        EXPECT_EQ(writer.nextSequence(), 5u);
+    }
+
+    fd = open(prepared.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, 4096), 0); // Sized, magic still 0
+    close(fd);
+    JournalWriter writer(mDirectory, 8, 0);
+    EXPECT_EQ(writer.nextSequence(), 5u);
+    for (uint64_t i = 5; i < 12; ++i) {
+        EXPECT_EQ(writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i)), i);
+    }
+}
+
+// Test case for a crash while creating the first segment of a new journal.
+TEST_F(JournalTest, WriterRecreatesUnfinishedFirstSegment) {
+    int fd = open((mDirectory + "/" + journalSegmentName(0)).c_str(), O_CREAT | O_RDWR, 0644);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    JournalWriter writer(mDirectory, 8, 0);
+    EXPECT_EQ(writer.nextSequence(), 0u);
+    uint64_t value = 0;
+    EXPECT_EQ(writer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(value)), 0u);
+}
+
+// Test case for segment files being allocated on disk up front, and flush() covering finished segments.
+TEST_F(JournalTest, SegmentsPreallocatedAndFlushed) {
+    JournalWriter writer(mDirectory, 64, 0);
+    for (uint64_t i = 0; i < 100; ++i) {
+        writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+    }
+    writer.flush(); // Waits for segment 0, retired by the roll, to be flushed as well
+
+    struct stat info;
+    ASSERT_EQ(stat((mDirectory + "/" + journalSegmentName(1)).c_str(), &info), 0);
+    EXPECT_GE(static_cast<size_t>(info.st_blocks) * 512, static_cast<size_t>(info.st_size)); // Not sparse
+
+    JournalReader reader(mDirectory);
+    uint8_t buffer[64];
+    size_t size = 0;
+    ASSERT_TRUE(reader.read(99, buffer, size));
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 99u);
+}
+
+// Test case for old segments being deleted by the maintenance thread, and a reader failing on them.
+TEST_F(JournalTest, RetiresOldSegments) {
+    JournalWriter writer(mDirectory, 4, 2);
+    JournalReader reader(mDirectory);
+    for (uint64_t i = 0; i < 40; ++i) {
+        writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (reader.oldestSequence() < 32 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(reader.oldestSequence(), 32u); // Segments 8 and 9 are kept
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_TRUE(reader.read(39, buffer, size));
+    EXPECT_FALSE(reader.read(3, buffer, size)); // Only the mapping the reader already held kept it alive
+}
+
+// Test case for a reader tailing the journal while the writer appends.
+TEST_F(JournalTest, ReaderTailsWriter) {
+    const uint64_t numMessages = 20000;
+    JournalWriter writer(mDirectory, 256, 0);
+    JournalReader reader(mDirectory);
+
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < numMessages; ++i) {
+            writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+        }
+    });
+
+    bool inOrder = true;
+    uint8_t buffer[64];
+    size_t size = 0;
+    for (uint64_t expected = 0; expected < numMessages;) {
+        if (reader.next(buffer, size)) {
+            inOrder = inOrder && *reinterpret_cast<uint64_t*>(buffer) == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(inOrder);
+}
+
+// Test case for seeking to the oldest, latest and end positions and to a checkpointed sequence.
+TEST_F(JournalTest, SeekPositions) {
+    JournalWriter writer(mDirectory, 8, 2);
+    for (uint64_t i = 0; i < 30; ++i) {
+        writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+    }
+    JournalReader reader(mDirectory);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (reader.oldestSequence() < 16 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_EQ(reader.endSequence(), 30u); // The prepared, empty segment 4 is not counted
+    reader.seekLatest();
+    ASSERT_TRUE(reader.next(buffer, size));
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 29u);
+
+    reader.seekOldest();
+    EXPECT_EQ(reader.position(), 16u);
+
+    EXPECT_FALSE(reader.seek(3)); // Retired
+    EXPECT_EQ(reader.position(), 16u);
+    ASSERT_TRUE(reader.seek(21));
+    ASSERT_TRUE(reader.next(buffer, size));
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 21u);
+
+    reader.seekEnd();
+    EXPECT_FALSE(reader.next(buffer, size));
+    uint64_t value = 30;
+    writer.append(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+    ASSERT_TRUE(reader.next(buffer, size));
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 30u);
+}
+
+// Test case for seeking by publish time across segments and past retired ones.
+TEST_F(JournalTest, SeekTimestamp) {
+    JournalWriter writer(mDirectory, 8, 0);
+    for (uint64_t i = 0; i < 100; ++i) {
+        writer.append(reinterpret_cast<const uint8_t*>(&i), sizeof(i), 1000 + 10 * i);
+    }
+
+    JournalReader reader(mDirectory);
+    uint8_t buffer[64];
+    size_t size = 0;
+    ASSERT_TRUE(reader.seekTimestamp(1555)); // Between 55 and 56, in segment 7
+    ASSERT_TRUE(reader.next(buffer, size));
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 56u);
+
+    EXPECT_TRUE(reader.seek(std::chrono::system_clock::time_point(std::chrono::nanoseconds(1000))));
+    EXPECT_EQ(reader.position(), 0u);
+    EXPECT_TRUE(reader.seekTimestamp(99999));
+    EXPECT_EQ(reader.position(), 100u);
+
+    unlink((mDirectory + "/" + journalSegmentName(0)).c_str()); // As if retired
+    EXPECT_FALSE(reader.seekTimestamp(1000));
+    EXPECT_EQ(reader.position(), 8u);
+}
+
+// Test case for opening a reader on a directory without a journal.
+TEST_F(JournalTest, ReaderRequiresJournal) {
+    EXPECT_THROW(JournalReader reader(mDirectory), std::runtime_error);
+}
@@ -0,0 +1,140 @@
+#include "../src/keyed_dispatcher.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct KeyedMessage {
+    uint32_t mKey;
+    uint32_t mSequence;
+};
+
+} // namespace
+
+// Test case for routing: a key always maps to one lane, and keys spread over every lane.
+TEST(KeyedDispatcherTest, KeysStickToOneLane) {
+    KeyedDispatcher dispatcher(4, 64);
+    uint8_t data[8] = {};
+    EXPECT_FALSE(dispatcher.enqueue(1, data, sizeof(data))); // No consumers yet
+
+    for (size_t lane = 0; lane < 4; ++lane) {
+        dispatcher.addConsumer(lane);
+    }
+
+    std::vector<int> perLane(4, 0);
+    for (uint64_t key = 0; key < 400; ++key) {
+        size_t lane = dispatcher.laneFor(key);
+        ASSERT_LT(lane, 4u);
+        EXPECT_EQ(dispatcher.laneFor(key), lane);
+        ++perLane[lane];
+    }
+    for (int count : perLane) {
+        EXPECT_GT(count, 50);
+    }
+}
+
+// Test case for rebalancing: adding a lane only moves keys onto it, and removing it moves them back.
+TEST(KeyedDispatcherTest, MembershipChangeMovesFewKeys) {
+    KeyedDispatcher dispatcher(4, 64);
+    for (size_t lane = 0; lane < 3; ++lane) {
+        dispatcher.addConsumer(lane);
+    }
+
+    std::vector<size_t> before;
+    for (uint64_t key = 0; key < 1000; ++key) {
+        before.push_back(dispatcher.laneFor(key));
+    }
+
+    dispatcher.addConsumer(3);
+    for (uint64_t key = 0; key < 1000; ++key) {
+        size_t lane = dispatcher.laneFor(key);
+        EXPECT_TRUE(lane == before[key] || lane == 3);
+    }
+
+    dispatcher.removeConsumer(3);
+    for (uint64_t key = 0; key < 1000; ++key) {
+        EXPECT_EQ(dispatcher.laneFor(key), before[key]);
+    }
+}
+
+// Test case for a full lane: the producer is refused instead of overwriting unread messages.
+TEST(KeyedDispatcherTest, FullLaneRejectsEnqueue) {
+    KeyedDispatcher dispatcher(1, 4);
+    dispatcher.addConsumer(0);
+    uint8_t data[8] = {};
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(dispatcher.enqueue(7, data, sizeof(data)));
+    }
+    EXPECT_FALSE(dispatcher.enqueue(7, data, sizeof(data)));
+
+    KeyedConsumer consumer(dispatcher, 0);
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_TRUE(consumer.dequeue(buffer, size));
+    consumer.complete();
+    EXPECT_TRUE(dispatcher.enqueue(7, data, sizeof(data)));
+}
+
+// Test case for per-key ordering while consumers join and leave mid-stream.
+// Every message must arrive once, and each key's sequence numbers must be seen in order.
+TEST(KeyedDispatcherTest, PerKeyOrderSurvivesRebalance) {
+    const size_t numLanes = 3;
+    const uint32_t numKeys = 32;
+    const uint32_t numMessages = 6000;
+    KeyedDispatcher dispatcher(numLanes, 256);
+    dispatcher.addConsumer(0);
+    dispatcher.addConsumer(1);
+
+    std::vector<std::atomic<uint32_t>> nextSequence(numKeys);
+    std::atomic<uint32_t> received(0);
+    std::atomic<bool> outOfOrder(false);
+
+    std::vector<std::thread> consumers;
+    for (size_t lane = 0; lane < numLanes; ++lane) {
+        consumers.emplace_back([&, lane]() {
+            KeyedConsumer consumer(dispatcher, lane);
+            uint8_t buffer[64];
+            size_t size = 0;
+            while (received.load() < numMessages) {
+                if (consumer.dequeue(buffer, size)) {
+                    KeyedMessage message;
+                    std::memcpy(&message, buffer, sizeof(message));
+                    if (nextSequence[message.mKey].load() != message.mSequence) {
+                        outOfOrder = true;
+                    }
+                    nextSequence[message.mKey].store(message.mSequence + 1);
+                    received.fetch_add(1);
+                }
+            }
+            consumer.complete();
+        });
+    }
+
+    std::vector<uint32_t> sent(numKeys, 0);
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        if (i == numMessages / 3) {
+            dispatcher.addConsumer(2);
+        } else if (i == 2 * numMessages / 3) {
+            dispatcher.removeConsumer(0);
+        }
+
+        KeyedMessage message{i % numKeys, sent[i % numKeys]++};
+        uint8_t data[sizeof(message)];
+        std::memcpy(data, &message, sizeof(message));
+        while (!dispatcher.enqueue(message.mKey, data, sizeof(data))) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    EXPECT_FALSE(outOfOrder.load());
+    EXPECT_EQ(received.load(), numMessages);
+    for (uint32_t key = 0; key < numKeys; ++key) {
+        EXPECT_EQ(nextSequence[key].load(), sent[key]);
+    }
+}
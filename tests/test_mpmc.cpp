@@ -0,0 +1,99 @@
+#include "../src/mpmc_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstring>
+
+// Test case for multiple producers and consumers.
+// Ensures multiple threads can enqueue and dequeue data concurrently.
+TEST(MPMCQueueTest, MultiProducerMultiConsumer) {
+    MPMCQueue queue(10);
+
+    auto producer = [&queue]() {
+        uint8_t data[64];
+        std::memset(data, 42, sizeof(data));
+        for (int i = 0; i < 5; ++i) {
+            while (!queue.enqueue(data, sizeof(data))) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    auto consumer = [&queue](uint8_t* buffer, size_t& size) {
+        for (int i = 0; i < 5; ++i) {
+            while (!queue.dequeue(buffer, size)) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    uint8_t buffer1[64], buffer2[64];
+    size_t size1, size2;
+
+    std::thread producer1(producer);
+    std::thread producer2(producer);
+    std::thread consumer1(consumer, buffer1, std::ref(size1));
+    std::thread consumer2(consumer, buffer2, std::ref(size2));
+
+    producer1.join();
+    producer2.join();
+    consumer1.join();
+    consumer2.join();
+
+    EXPECT_EQ(buffer1[0], 42);
+    EXPECT_EQ(buffer2[0], 42);
+}
+
+// Test case for several producers publishing distinct values concurrently.
+// The ring is large enough that nothing is overwritten, so every value must arrive exactly once.
+TEST(MPMCQueueTest, EveryMessageArrivesOnce) {
+    const int numProducers = 4;
+    const int perProducer = 250;
+    MPMCQueue queue(numProducers * perProducer);
+
+    std::vector<std::atomic<int>> seen(numProducers * perProducer);
+    for (auto& count : seen) {
+        count = 0;
+    }
+
+    auto producer = [&queue](int id) {
+        for (int i = 0; i < perProducer; ++i) {
+            uint32_t value = id * perProducer + i;
+            uint8_t data[64];
+            std::memset(data, 0, sizeof(data));
+            std::memcpy(data, &value, sizeof(value));
+            EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+        }
+    };
+
+    std::atomic<int> received{0};
+    auto consumer = [&]() {
+        uint8_t buffer[64];
+        size_t size = 0;
+        while (received.load() < numProducers * perProducer) {
+            if (!queue.dequeue(buffer, size)) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint32_t value = 0;
+            std::memcpy(&value, buffer, sizeof(value));
+            ++seen[value];
+            ++received;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numProducers; ++i) {
+        threads.emplace_back(producer, i);
+    }
+    threads.emplace_back(consumer);
+    threads.emplace_back(consumer);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (auto& count : seen) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
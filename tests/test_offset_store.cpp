@@ -0,0 +1,122 @@
+#include "../src/offset_store.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../src/spmc_cursor.h"
+
+// Offset file per test process, removed when the test ends.
+class OffsetStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        mPath = "/tmp/spmc_offsets_" + std::to_string(getpid()) + "_"
+                + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        unlink(mPath.c_str());
+    }
+
+    void TearDown() override {
+        unlink(mPath.c_str());
+    }
+
+    std::string mPath;
+};
+
+// Test case for offsets surviving the store being closed and reopened, as after a consumer restart.
+TEST_F(OffsetStoreTest, ResumesAfterReopen) {
+    {
+        OffsetStore store(mPath);
+        ConsumerOffset risk = store.consumer("risk");
+        EXPECT_EQ(risk.load(7), 7u); // Never committed
+        risk.commit(1234);
+        store.consumer("journal").commit(99);
+    }
+
+    OffsetStore store(mPath);
+    EXPECT_EQ(store.consumer("risk").load(), 1234u);
+    EXPECT_EQ(store.consumer("journal").load(), 99u);
+    EXPECT_EQ(store.consumer("new").load(5), 5u);
+}
+
+// Test case for two mappings of the same file, as in two processes, seeing each other's names and commits.
+TEST_F(OffsetStoreTest, SharedBetweenMappings) {
+    OffsetStore first(mPath);
+    OffsetStore second(mPath);
+    ConsumerOffset writer = first.consumer("strategy");
+    ConsumerOffset reader = second.consumer("strategy");
+    writer.commit(42);
+    EXPECT_EQ(reader.load(), 42u);
+    EXPECT_STREQ(reader.name(), "strategy");
+}
+
+// Test case for invalid names and a full store.
+TEST_F(OffsetStoreTest, RejectsBadNamesAndOverflow) {
+    OffsetStore store(mPath);
+    EXPECT_THROW(store.consumer(""), std::invalid_argument);
+    EXPECT_THROW(store.consumer(std::string(kOffsetNameSize, 'x')), std::invalid_argument);
+    for (size_t i = 0; i < kMaxOffsetConsumers; ++i) {
+        store.consumer("consumer" + std::to_string(i));
+    }
+    EXPECT_THROW(store.consumer("one_too_many"), std::runtime_error);
+    EXPECT_NO_THROW(store.consumer("consumer3")); // Existing names still resolve
+}
+
+// Test case for a cursor checkpointing into the store and a restarted cursor resuming from it.
+TEST_F(OffsetStoreTest, CursorResumesFromCheckpoint) {
+    SPMCQueue queue(64);
+    for (uint64_t i = 0; i < 20; ++i) {
+        queue.enqueue(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+    }
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    {
+        OffsetStore store(mPath);
+        store.start(std::chrono::milliseconds(1));
+        SPMCCursor cursor(queue);
+        cursor.seekOldest();
+        for (int i = 0; i < 12; ++i) {
+            ASSERT_EQ(cursor.read(buffer, size), DequeueResult::Success);
+        }
+        store.consumer("display").commit(cursor.position());
+    }
+
+    OffsetStore store(mPath);
+    SPMCCursor cursor(queue);
+    ASSERT_TRUE(cursor.seek(store.consumer("display").load()));
+    ASSERT_EQ(cursor.read(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 12u);
+}
+
+// Test case for opening a file that is not an offset store.
+TEST_F(OffsetStoreTest, RejectsForeignFile) {
+    FILE* file = fopen(mPath.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    fputs("not an offset store", file);
+    fclose(file);
+    EXPECT_THROW(OffsetStore store(mPath), std::runtime_error);
+}
+
+// Test case for a file whose creator crashed after sizing it but before writing the magic.
+TEST_F(OffsetStoreTest, InitialisesUnfinishedFile) {
+    int fd = open(mPath.c_str(), O_CREAT | O_RDWR, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, sizeof(OffsetStoreLayout)), 0);
+    close(fd);
+
+    OffsetStore store(mPath);
+    store.consumer("display").commit(7);
+    EXPECT_EQ(store.consumer("display").load(), 7u);
+    EXPECT_NO_THROW(store.flush());
+}
+
+// Test case for stop() not waiting out the flush thread's interval.
+TEST_F(OffsetStoreTest, StopDoesNotWaitForInterval) {
+    OffsetStore store(mPath);
+    store.start(std::chrono::hours(1));
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_NO_THROW(store.stop());
+    EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(10));
+}
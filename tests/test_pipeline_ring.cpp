@@ -0,0 +1,92 @@
+#include "../src/pipeline_ring.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Test case for a stage only seeing what its upstream stage has released, and the producer gating on the
+// final stage.
+TEST(PipelineRingTest, StagesRespectDependencies) {
+    PipelineRing ring(4);
+    size_t decode = ring.addStage();
+    size_t risk = ring.addStage({decode});
+    auto count = [](uint64_t, uint8_t*, size_t) {};
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPublish(&i, 1));
+    }
+    uint8_t extra = 99;
+    EXPECT_FALSE(ring.tryPublish(&extra, 1)); // Full until the final stage moves
+
+    EXPECT_EQ(ring.process(risk, count), 0u); // Decode has not run yet
+    EXPECT_EQ(ring.process(decode, count, 2), 2u);
+    EXPECT_FALSE(ring.tryPublish(&extra, 1)); // Decode is not the final stage
+    EXPECT_EQ(ring.process(risk, count), 2u);
+    EXPECT_EQ(ring.cursor(risk), 2u);
+    EXPECT_TRUE(ring.tryPublish(&extra, 1));
+}
+
+// Test case for upstream ids that do not name an earlier stage.
+TEST(PipelineRingTest, RejectsUnknownUpstream) {
+    PipelineRing ring(4);
+    EXPECT_THROW(ring.addStage({0}), std::invalid_argument);
+    size_t first = ring.addStage();
+    EXPECT_THROW(ring.addStage({first, first + 1}), std::invalid_argument);
+}
+
+// Test case for a decode -> (risk, audit) -> journal diamond running on its own threads. Decode rewrites the
+// payload in place and every later stage must see the rewritten value, in order, with nothing missing.
+TEST(PipelineRingTest, DiamondPipelineSeesInPlaceUpdates) {
+    const uint64_t numMessages = 50000;
+    PipelineRing ring(64);
+    size_t decode = ring.addStage();
+    size_t risk = ring.addStage({decode});
+    size_t audit = ring.addStage({decode});
+    size_t journal = ring.addStage({risk, audit});
+
+    auto runStage = [&](size_t stage, bool rewrite, bool& ok) {
+        uint64_t expected = 0;
+        while (expected < numMessages) {
+            size_t processed = ring.process(stage, [&](uint64_t sequence, uint8_t* data, size_t size) {
+                uint64_t value = 0;
+                std::memcpy(&value, data, sizeof(value));
+                if (sequence != expected || size != sizeof(value) || value != (rewrite ? sequence : ~sequence)) {
+                    ok = false;
+                }
+                if (rewrite) {
+                    value = ~value;
+                    std::memcpy(data, &value, sizeof(value));
+                }
+                ++expected;
+            });
+            if (processed == 0) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    bool decodeOk = true, riskOk = true, auditOk = true, journalOk = true;
+    std::vector<std::thread> stages;
+    stages.emplace_back(runStage, decode, true, std::ref(decodeOk));
+    stages.emplace_back(runStage, risk, false, std::ref(riskOk));
+    stages.emplace_back(runStage, audit, false, std::ref(auditOk));
+    stages.emplace_back(runStage, journal, false, std::ref(journalOk));
+
+    for (uint64_t i = 0; i < numMessages;) {
+        if (ring.tryPublish(reinterpret_cast<const uint8_t*>(&i), sizeof(i))) {
+            ++i;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& stage : stages) {
+        stage.join();
+    }
+
+    EXPECT_TRUE(decodeOk);
+    EXPECT_TRUE(riskOk);
+    EXPECT_TRUE(auditOk);
+    EXPECT_TRUE(journalOk);
+    EXPECT_EQ(ring.cursor(journal), numMessages);
+}
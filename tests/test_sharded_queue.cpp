@@ -0,0 +1,99 @@
+#include "../src/sharded_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Test case for round-robin distribution across shards.
+TEST(ShardedSPMCQueueTest, RoundRobinSpreadsAcrossShards) {
+    ShardedSPMCQueue queue(4, 16);
+    uint8_t data[8] = {};
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    }
+    for (size_t i = 0; i < queue.shardCount(); ++i) {
+        EXPECT_EQ(queue.shard(i).depth(), 2u);
+    }
+}
+
+// Test case for keyed enqueue: the same key always lands in the same shard.
+TEST(ShardedSPMCQueueTest, KeyedEnqueueIsStable) {
+    ShardedSPMCQueue queue(4, 16);
+    uint8_t data[8] = {};
+    size_t target = queue.shardFor(12345);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(queue.enqueue(12345, data, sizeof(data)));
+    }
+    EXPECT_EQ(queue.shard(target).depth(), 5u);
+}
+
+// Test case for an idle consumer stealing from another consumer's shard.
+TEST(ShardedSPMCQueueTest, IdleConsumerStealsBatch) {
+    ShardedSPMCQueue queue(2, 64);
+    size_t busy = queue.shardFor(7);
+    ShardConsumer thief(queue, busy + 1);
+
+    for (uint8_t i = 0; i < 40; ++i) {
+        EXPECT_TRUE(queue.enqueue(7, &i, 1));
+    }
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_TRUE(thief.dequeue(buffer, size));
+    EXPECT_EQ(buffer[0], 0);
+    EXPECT_EQ(thief.stolen(), ShardConsumer::kStealBatch);
+    EXPECT_EQ(queue.shard(busy).depth(), 40u - ShardConsumer::kStealBatch);
+
+    // The stash is served in order before the shards are visited again
+    for (uint8_t i = 1; i < ShardConsumer::kStealBatch; ++i) {
+        EXPECT_TRUE(thief.dequeue(buffer, size));
+        EXPECT_EQ(buffer[0], i);
+    }
+}
+
+// Test case for several consumers draining a sharded queue with stealing.
+// Each message must be delivered exactly once.
+TEST(ShardedSPMCQueueTest, ConsumersDeliverEveryMessageOnce) {
+    const int numShards = 4;
+    const int numMessages = 4000;
+    ShardedSPMCQueue queue(numShards, numMessages);
+    std::vector<std::atomic<int>> seen(numMessages);
+    std::atomic<int> received(0);
+
+    // Skew the load so that most messages land in shard 0 and the other consumers have to steal
+    for (int i = 0; i < numMessages; ++i) {
+        uint8_t data[sizeof(int)];
+        std::memcpy(data, &i, sizeof(i));
+        if (i % 8 == 0) {
+            EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+        } else {
+            EXPECT_TRUE(queue.shard(0).enqueue(data, sizeof(data)));
+        }
+    }
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < numShards; ++c) {
+        consumers.emplace_back([&queue, &seen, &received, c]() {
+            ShardConsumer consumer(queue, c);
+            uint8_t buffer[64];
+            size_t size = 0;
+            while (received.load() < numMessages) {
+                if (consumer.dequeue(buffer, size)) {
+                    int value;
+                    std::memcpy(&value, buffer, sizeof(value));
+                    seen[value].fetch_add(1);
+                    received.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    EXPECT_EQ(received.load(), numMessages);
+    for (int i = 0; i < numMessages; ++i) {
+        EXPECT_EQ(seen[i].load(), 1) << "message " << i;
+    }
+}
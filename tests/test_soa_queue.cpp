@@ -0,0 +1,149 @@
+#include "../src/soa_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Test case for single-block enqueue and dequeue.
+TEST(SoASPMCQueueTest, SingleProducerSingleConsumer) {
+    SoASPMCQueue queue(10);
+
+    uint8_t data[64];
+    std::memset(data, 42, sizeof(data));
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    EXPECT_EQ(queue.depth(), 1u);
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(size, sizeof(data));
+    EXPECT_EQ(buffer[63], 42);
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Empty);
+}
+
+// Test case for batch dequeue: the run of ready blocks is claimed at once, in order, and stops at the
+// first block that has not been published and at the end of the ring.
+TEST(SoASPMCQueueTest, BatchClaimsReadyRun) {
+    SoASPMCQueue queue(16);
+    for (uint8_t i = 0; i < 13; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+
+    uint8_t buffers[SoASPMCQueue::kMaxBatch * 64];
+    size_t sizes[SoASPMCQueue::kMaxBatch];
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, 3), 3u);
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, SoASPMCQueue::kMaxBatch), 10u);
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(sizes[i], 1u);
+        EXPECT_EQ(buffers[i * 64], i + 3);
+    }
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, SoASPMCQueue::kMaxBatch), 0u);
+
+    // Positions 13..15 end the ring; 16..17 start the next lap and need a second batch
+    for (uint8_t i = 13; i < 18; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, SoASPMCQueue::kMaxBatch), 3u);
+    EXPECT_EQ(buffers[0], 13);
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, SoASPMCQueue::kMaxBatch), 2u);
+    EXPECT_EQ(buffers[64], 17);
+}
+
+// Test case for a lapped consumer, which skips to the oldest block still in the ring.
+TEST(SoASPMCQueueTest, LappedConsumerSkipsToOldestBlock) {
+    SoASPMCQueue queue(4);
+    for (uint8_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+
+    uint8_t buffers[SoASPMCQueue::kMaxBatch * 64];
+    size_t sizes[SoASPMCQueue::kMaxBatch];
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, 8), 0u); // Position 0 was overwritten
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, 8), 2u); // Positions 6 and 7, up to the end of the ring
+    EXPECT_EQ(buffers[0], 6);
+    EXPECT_EQ(queue.dequeueBatch(buffers, sizes, 8), 2u);
+    EXPECT_EQ(buffers[64], 9);
+}
+
+// Test case for several consumers mixing batch and single dequeues.
+// The ring holds every message, so each one must be delivered exactly once.
+TEST(SoASPMCQueueTest, ConsumersDeliverEveryMessageOnce) {
+    const int numConsumers = 4;
+    const int numMessages = 20000;
+    SoASPMCQueue queue(numMessages);
+    std::vector<std::atomic<int>> seen(numMessages);
+    std::atomic<int> received(0);
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&queue, &seen, &received, c]() {
+            uint8_t buffers[SoASPMCQueue::kMaxBatch * 64];
+            size_t sizes[SoASPMCQueue::kMaxBatch];
+            while (received.load() < numMessages) {
+                size_t count = 0;
+                if (c % 2 == 0) {
+                    count = queue.dequeueBatch(buffers, sizes, 16);
+                } else {
+                    count = queue.dequeue(buffers, sizes[0]) ? 1 : 0;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    int value;
+                    std::memcpy(&value, buffers + i * 64, sizeof(value));
+                    seen[value].fetch_add(1);
+                }
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+                received.fetch_add(static_cast<int>(count));
+            }
+        });
+    }
+
+    for (int i = 0; i < numMessages; ++i) {
+        uint8_t data[sizeof(int)];
+        std::memcpy(data, &i, sizeof(i));
+        EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    }
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    EXPECT_EQ(received.load(), numMessages);
+    for (int i = 0; i < numMessages; ++i) {
+        EXPECT_EQ(seen[i].load(), 1) << "message " << i;
+    }
+}
+
+// Fixture with access to the copy phase of dequeueBatch, so a test can lap the ring after a run was claimed.
+class SoASPMCQueueLapTest : public ::testing::Test {
+protected:
+    static std::atomic<uint64_t>& header(SoASPMCQueue& queue, size_t index) {
+        return queue.header(index);
+    }
+
+    static size_t copyClaimed(SoASPMCQueue& queue, size_t position, size_t count, uint8_t* buffers,
+                              size_t* sizes) {
+        return queue.copyClaimed(position, count, buffers, sizes);
+    }
+};
+
+// Test case for a producer lapping the ring between the claim and the copy: blocks already published for the
+// next lap and blocks being rewritten are skipped rather than returned.
+TEST_F(SoASPMCQueueLapTest, CopySkipsBlocksOfLaterLap) {
+    SoASPMCQueue queue(4);
+    for (uint8_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+    // Positions 0 to 3 are claimed here; the producer then republishes 0 and 1 and starts rewriting 2
+    for (uint8_t i = 4; i < 6; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+    header(queue, 2).store(packBlockHeader(writingSequence(1), 0));
+
+    uint8_t buffers[4 * 64];
+    size_t sizes[4];
+    ASSERT_EQ(copyClaimed(queue, 0, 4, buffers, sizes), 1u);
+    EXPECT_EQ(sizes[0], 1u);
+    EXPECT_EQ(buffers[0], 3);
+}
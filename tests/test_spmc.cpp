@@ -1,8 +1,10 @@
 #include "../src/spmc_queue.h"
+#include "../src/block_copy.h"
 #include <gtest/gtest.h>
 #include <thread>
 #include <cstring>
 #include <mutex>
+#include <vector>
 
 // Test case for a single producer and a single consumer.
 // It enqueues data and ensures it can be dequeued correctly.
@@ -49,6 +51,220 @@ TEST(SPMCQueueTest, DequeueWhenEmpty) {
     EXPECT_FALSE(queue.dequeue(buffer, size));
 }
 
+// Test case for tryDequeue reporting why an attempt failed.
+// An empty queue reports Empty, a published block reports Success.
+TEST(SPMCQueueTest, TryDequeueReportsResult) {
+    SPMCQueue queue(10);
+
+    uint8_t data[64];
+    std::memset(data, 7, sizeof(data));
+
+    uint8_t buffer[64];
+    size_t size = 0;
+
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Empty);
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(size, sizeof(data));
+    EXPECT_EQ(buffer[0], 7);
+}
+
+// Test case for dequeueing after the ring has wrapped.
+// A block that was already consumed must not be handed out again.
+TEST(SPMCQueueTest, DequeueAfterWrapDoesNotRereadConsumedBlock) {
+    SPMCQueue queue(2);
+
+    uint8_t data[64];
+    uint8_t buffer[64];
+    size_t size = 0;
+
+    for (uint8_t i = 1; i <= 2; ++i) {
+        std::memset(data, i, sizeof(data));
+        EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+        EXPECT_TRUE(queue.dequeue(buffer, size));
+        EXPECT_EQ(buffer[0], i);
+    }
+
+    EXPECT_FALSE(queue.dequeue(buffer, size));
+}
+
+// Test case for a consumer that the producer has lapped.
+// Overwritten blocks are skipped and the consumer resumes at the oldest block still in the ring.
+TEST(SPMCQueueTest, LappedConsumerSkipsToOldestBlock) {
+    SPMCQueue queue(2);
+
+    uint8_t data[64];
+    for (uint8_t i = 1; i <= 5; ++i) {
+        std::memset(data, i, sizeof(data));
+        EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    }
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Contended); // Position 0 was overwritten
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(buffer[0], 4);
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(buffer[0], 5);
+    EXPECT_EQ(queue.tryDequeue(buffer, size), DequeueResult::Empty);
+}
+
+// Test case for the payload copy kernels.
+// Full 64-byte payloads take the fixed-size path, other sizes fall back to memcpy; both must round-trip.
+TEST(SPMCQueueTest, CopyKernelsRoundTrip) {
+    alignas(64) uint8_t block[kBlockPayloadSize];
+    uint8_t data[kBlockPayloadSize + 1];
+    uint8_t buffer[kBlockPayloadSize + 1];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+
+    // Offset by one byte so the caller side is unaligned
+    for (size_t size : {size_t{64}, size_t{40}, size_t{1}}) {
+        std::memset(block, 0, sizeof(block));
+        std::memset(buffer, 0, sizeof(buffer));
+        copyToBlock(block, data + 1, size);
+        copyFromBlock(buffer + 1, block, size);
+        EXPECT_EQ(std::memcmp(buffer + 1, data + 1, size), 0) << "size " << size;
+
+        std::memset(block, 0, sizeof(block));
+        streamToBlock(block, data + 1, size);
+        streamFence();
+        EXPECT_EQ(std::memcmp(block, data + 1, size), 0) << "size " << size;
+    }
+}
+
+// Test case for a queue writing payloads with non-temporal stores.
+TEST(SPMCQueueTest, NonTemporalStoreMode) {
+    SPMCQueue queue(4, StoreMode::NonTemporal);
+
+    uint8_t data[64];
+    uint8_t buffer[64];
+    size_t size = 0;
+    for (uint8_t i = 1; i <= 6; ++i) {
+        std::memset(data, i, sizeof(data));
+        EXPECT_TRUE(queue.enqueue(data, i % 2 == 0 ? sizeof(data) : 24));
+        EXPECT_TRUE(queue.dequeue(buffer, size));
+        EXPECT_EQ(size, i % 2 == 0 ? sizeof(data) : 24u);
+        EXPECT_EQ(buffer[0], i);
+        EXPECT_EQ(buffer[size - 1], i);
+    }
+}
+
+// Test case for prefetching ahead of head and tail.
+// Prefetching is only a hint, so every distance (including one clamped to the capacity) must behave the same.
+TEST(SPMCQueueTest, PrefetchDistanceDoesNotChangeResults) {
+    for (size_t distance : {size_t{0}, size_t{1}, size_t{3}, size_t{100}}) {
+        SPMCQueue queue(4, StoreMode::Cached, distance);
+
+        uint8_t data[64];
+        uint8_t buffer[64];
+        size_t size = 0;
+        for (uint8_t i = 1; i <= 10; ++i) {
+            std::memset(data, i, sizeof(data));
+            EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+            EXPECT_TRUE(queue.dequeue(buffer, size));
+            EXPECT_EQ(buffer[0], i) << "distance " << distance;
+        }
+        EXPECT_FALSE(queue.dequeue(buffer, size));
+    }
+}
+
+// Test case for drain: the ready run is handed over in place and in order, up to the limit and the end of
+// the ring, and a drained block is not dequeued again.
+TEST(SPMCQueueTest, DrainHandsOverReadyRun) {
+    SPMCQueue queue(8);
+    for (uint8_t i = 0; i < 6; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+
+    std::vector<uint8_t> seen;
+    auto handler = [&seen](const uint8_t* data, size_t size) {
+        EXPECT_EQ(size, 1u);
+        seen.push_back(data[0]);
+    };
+    EXPECT_EQ(queue.drain(handler, 4), 4u);
+    EXPECT_EQ(queue.drain(handler), 2u);
+    EXPECT_EQ(queue.drain(handler), 0u);
+    ASSERT_EQ(seen.size(), 6u);
+    for (uint8_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(seen[i], i);
+    }
+
+    // Positions 6 and 7 end the ring, 8 starts the next lap
+    for (uint8_t i = 6; i < 9; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+    EXPECT_EQ(queue.drain(handler), 2u);
+    EXPECT_EQ(queue.drain(handler), 1u);
+    EXPECT_EQ(seen.back(), 8);
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_FALSE(queue.dequeue(buffer, size));
+}
+
+// Test case for copying a ready run out with one claim, split at the end of the ring.
+TEST(SPMCQueueTest, DequeueBatchCopiesReadyRun) {
+    SPMCQueue queue(8);
+    for (uint8_t i = 0; i < 6; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+
+    uint8_t buffers[8][64];
+    size_t sizes[8];
+    ASSERT_EQ(queue.dequeueBatch(&buffers[0][0], sizes, 4), 4u);
+    for (uint8_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(sizes[i], 1u);
+        EXPECT_EQ(buffers[i][0], i);
+    }
+    EXPECT_EQ(queue.depth(), 2u);
+
+    for (uint8_t i = 6; i < 10; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+    ASSERT_EQ(queue.dequeueBatch(&buffers[0][0], sizes, 8), 4u); // Positions 4 to 7 end the ring
+    EXPECT_EQ(buffers[3][0], 7);
+    ASSERT_EQ(queue.dequeueBatch(&buffers[0][0], sizes, 8), 2u);
+    EXPECT_EQ(buffers[1][0], 9);
+    EXPECT_EQ(queue.dequeueBatch(&buffers[0][0], sizes, 8), 0u);
+}
+
+// Test case for the statistics snapshot.
+// Depth is always reported; the counters are only collected when built with SPMC_ENABLE_STATS.
+TEST(SPMCQueueTest, StatsSnapshot) {
+    SPMCQueue queue(2);
+
+    uint8_t data[64];
+    std::memset(data, 1, sizeof(data));
+    uint8_t buffer[64];
+    size_t size = 0;
+
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    EXPECT_EQ(queue.stats().mDepth, 1u);
+    EXPECT_TRUE(queue.dequeue(buffer, size));
+    EXPECT_EQ(queue.stats().mDepth, 0u);
+
+    // Fill the ring and lap it once, overwriting one unread block
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+
+    QueueStats stats = queue.stats();
+#ifdef SPMC_ENABLE_STATS
+    EXPECT_TRUE(stats.mEnabled);
+    EXPECT_EQ(stats.mPublished, 4u);
+    EXPECT_EQ(stats.mOverwrites, 1u);
+    EXPECT_EQ(stats.mConsumed, 1u);
+    EXPECT_EQ(stats.mDepth, 2u);
+    ASSERT_EQ(stats.mConsumers.size(), 1u);
+    EXPECT_EQ(stats.mConsumers[0].mConsumed, 1u);
+#else
+    EXPECT_FALSE(stats.mEnabled);
+    EXPECT_EQ(stats.mPublished, 0u);
+#endif
+}
+
 // Test case for multiple consumers dequeueing from the queue.
 // Ensures each consumer retrieves consecutive entries correctly.
 TEST(SPMCQueueTest, MultipleConsumers) {
@@ -72,46 +288,6 @@ TEST(SPMCQueueTest, MultipleConsumers) {
     EXPECT_NE(buffer1, buffer2);
 }
 
-// Test case for multiple producers and consumers.
-// Ensures multiple threads can enqueue and dequeue data concurrently.
-TEST(SPMCQueueTest, MultiProducerMultiConsumer) {
-    SPMCQueue queue(10);
-
-    auto producer = [&queue]() {
-        uint8_t data[64];
-        std::memset(data, 42, sizeof(data));
-        for (int i = 0; i < 5; ++i) {
-            while (!queue.enqueue(data, sizeof(data))) {
-                std::this_thread::yield();
-            }
-        }
-    };
-
-    auto consumer = [&queue](uint8_t* buffer, size_t& size) {
-        for (int i = 0; i < 5; ++i) {
-            while (!queue.dequeue(buffer, size)) {
-                std::this_thread::yield();
-            }
-        }
-    };
-
-    uint8_t buffer1[64], buffer2[64];
-    size_t size1, size2;
-
-    std::thread producer1(producer);
-    std::thread producer2(producer);
-    std::thread consumer1(consumer, buffer1, std::ref(size1));
-    std::thread consumer2(consumer, buffer2, std::ref(size2));
-
-    producer1.join();
-    producer2.join();
-    consumer1.join();
-    consumer2.join();
-
-    EXPECT_EQ(buffer1[0], 42);
-    EXPECT_EQ(buffer2[0], 42);
-}
-
 // Global counter for consumer tests
 int counter = 0;
 std::mutex mtx;
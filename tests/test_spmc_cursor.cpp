@@ -0,0 +1,196 @@
+#include "../src/spmc_cursor.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+static void enqueueValues(SPMCQueue& queue, uint64_t from, uint64_t to) {
+    for (uint64_t i = from; i < to; ++i) {
+        queue.enqueue(reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+    }
+}
+
+// Test case for the start positions: end, latest and oldest.
+TEST(SPMCCursorTest, SeekPositions) {
+    SPMCQueue queue(8);
+    enqueueValues(queue, 0, 5);
+
+    SPMCCursor cursor(queue);
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_EQ(cursor.position(), 5u);
+    EXPECT_EQ(cursor.read(buffer, size), DequeueResult::Empty); // Starts after what is already there
+
+    cursor.seekLatest();
+    ASSERT_EQ(cursor.read(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 4u);
+
+    cursor.seekOldest();
+    ASSERT_EQ(cursor.read(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 0u);
+}
+
+// Test case for resuming from a saved sequence, and refusing one the producer has overwritten.
+TEST(SPMCCursorTest, SeekToSequence) {
+    SPMCQueue queue(8);
+    enqueueValues(queue, 0, 20);
+
+    SPMCCursor cursor(queue);
+    EXPECT_EQ(cursor.oldestSequence(), 13u);
+    EXPECT_FALSE(cursor.seek(5));
+    EXPECT_EQ(cursor.position(), 20u);
+
+    ASSERT_TRUE(cursor.seek(15));
+    uint8_t buffer[64];
+    size_t size = 0;
+    for (uint64_t expected = 15; expected < 20; ++expected) {
+        ASSERT_EQ(cursor.read(buffer, size), DequeueResult::Success);
+        EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), expected);
+    }
+    EXPECT_EQ(cursor.read(buffer, size), DequeueResult::Empty);
+}
+
+// Test case for seeking by publish time, including times between stamps, before the ring and after it.
+TEST(SPMCCursorTest, SeekTimestamp) {
+    SPMCQueue queue(16);
+    for (uint64_t i = 0; i < 10; ++i) {
+        queue.enqueue(reinterpret_cast<const uint8_t*>(&i), sizeof(i), 1000 + 10 * i);
+    }
+
+    SPMCCursor cursor(queue);
+    uint8_t buffer[64];
+    size_t size = 0;
+    ASSERT_TRUE(cursor.seekTimestamp(1035)); // Between the stamps of 3 and 4
+    ASSERT_EQ(cursor.read(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 4u);
+
+    ASSERT_TRUE(cursor.seekTimestamp(1050)); // Exact stamp
+    EXPECT_EQ(cursor.position(), 5u);
+    EXPECT_TRUE(cursor.seekTimestamp(0));
+    EXPECT_EQ(cursor.position(), 0u);
+    EXPECT_TRUE(cursor.seekTimestamp(5000)); // Later than everything: wait for new blocks
+    EXPECT_EQ(cursor.position(), 10u);
+
+    using Clock = std::chrono::system_clock;
+    EXPECT_TRUE(cursor.seek(Clock::time_point(std::chrono::nanoseconds(1020))));
+    EXPECT_EQ(cursor.position(), 2u);
+}
+
+// Test case for a timestamp seek that reaches back past what the ring still holds.
+TEST(SPMCCursorTest, SeekTimestampBeforeRing) {
+    SPMCQueue queue(8);
+    for (uint64_t i = 0; i < 20; ++i) {
+        queue.enqueue(reinterpret_cast<const uint8_t*>(&i), sizeof(i), 1000 + 10 * i);
+    }
+    SPMCCursor cursor(queue);
+    EXPECT_FALSE(cursor.seekTimestamp(1005));
+    EXPECT_EQ(cursor.position(), cursor.oldestSequence());
+    EXPECT_TRUE(cursor.seekTimestamp(1175));
+    EXPECT_EQ(cursor.position(), 18u);
+}
+
+// Test case for the subscription bitmap, including topics outside its range.
+TEST(SPMCCursorTest, TopicSetMembership) {
+    TopicSet topics;
+    topics.add(3);
+    topics.add(700);
+    topics.add(kMaxTopics); // Ignored
+    EXPECT_TRUE(topics.contains(3));
+    EXPECT_TRUE(topics.contains(700));
+    EXPECT_FALSE(topics.contains(4));
+    EXPECT_FALSE(topics.contains(kMaxTopics));
+    topics.remove(3);
+    EXPECT_FALSE(topics.contains(3));
+}
+
+// Test case for a subscribed cursor only returning blocks of its topics, in order, while another cursor
+// still sees everything.
+TEST(SPMCCursorTest, SubscriptionFiltersTopics) {
+    SPMCQueue queue(64);
+    SPMCCursor filtered(queue);
+    SPMCCursor all(queue);
+    TopicSet topics;
+    topics.add(1);
+    topics.add(5);
+    filtered.subscribe(topics);
+
+    for (uint64_t i = 0; i < 30; ++i) {
+        queue.enqueue(reinterpret_cast<const uint8_t*>(&i), sizeof(i), 0, static_cast<uint32_t>(i % 6));
+    }
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    for (uint64_t i = 0; i < 30; ++i) {
+        if (i % 6 == 1 || i % 6 == 5) {
+            ASSERT_EQ(filtered.read(buffer, size), DequeueResult::Success);
+            EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), i);
+        }
+    }
+    EXPECT_EQ(filtered.read(buffer, size), DequeueResult::Empty);
+    EXPECT_EQ(filtered.position(), 30u); // The trailing skipped blocks are consumed too
+
+    for (uint64_t i = 0; i < 30; ++i) {
+        ASSERT_EQ(all.read(buffer, size), DequeueResult::Success);
+    }
+
+    filtered.subscribeAll();
+    uint64_t untagged = 30;
+    queue.enqueue(reinterpret_cast<const uint8_t*>(&untagged), sizeof(untagged));
+    ASSERT_EQ(filtered.read(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 30u);
+}
+
+// Test case for a cursor the producer laps moving on to the oldest block still in the ring.
+TEST(SPMCCursorTest, LappedCursorSkipsAhead) {
+    SPMCQueue queue(8);
+    SPMCCursor cursor(queue);
+    enqueueValues(queue, 0, 30);
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_EQ(cursor.read(buffer, size), DequeueResult::Contended);
+    EXPECT_EQ(cursor.position(), 23u);
+    ASSERT_EQ(cursor.read(buffer, size), DequeueResult::Success);
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 23u);
+}
+
+// Test case for cursors seeing every block without taking any from the regular consumers.
+TEST(SPMCCursorTest, DoesNotClaimBlocks) {
+    SPMCQueue queue(64);
+    SPMCCursor first(queue);
+    SPMCCursor second(queue);
+    enqueueValues(queue, 0, 10);
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    for (uint64_t expected = 0; expected < 10; ++expected) {
+        ASSERT_EQ(first.read(buffer, size), DequeueResult::Success);
+        ASSERT_EQ(second.read(buffer, size), DequeueResult::Success);
+        EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), expected);
+    }
+    EXPECT_EQ(queue.depth(), 10u);
+    ASSERT_TRUE(queue.dequeue(buffer, size));
+    EXPECT_EQ(*reinterpret_cast<uint64_t*>(buffer), 0u);
+}
+
+// Test case for a cursor following a running producer without losing blocks when the ring is large enough.
+TEST(SPMCCursorTest, FollowsProducer) {
+    const uint64_t numMessages = 20000;
+    SPMCQueue queue(numMessages);
+    SPMCCursor cursor(queue);
+    std::thread producer(enqueueValues, std::ref(queue), 0, numMessages);
+
+    bool inOrder = true;
+    uint8_t buffer[64];
+    size_t size = 0;
+    for (uint64_t expected = 0; expected < numMessages;) {
+        DequeueResult result = cursor.read(buffer, size);
+        if (result == DequeueResult::Success) {
+            inOrder = inOrder && *reinterpret_cast<uint64_t*>(buffer) == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(inOrder);
+}
@@ -0,0 +1,66 @@
+#include "../src/spsc_queue.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// Test case for the compile-time selection between SPSCQueue and SPMCQueue.
+TEST(SPSCQueueTest, SelectedForOneConsumer) {
+    EXPECT_TRUE((std::is_same<SPMCQueueFor<1>, SPSCQueue>::value));
+    EXPECT_TRUE((std::is_same<SPMCQueueFor<4>, SPMCQueue>::value));
+}
+
+// Test case for FIFO order and the full/empty boundaries.
+TEST(SPSCQueueTest, FullAndEmpty) {
+    SPSCQueue queue(4);
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_FALSE(queue.dequeue(buffer, size));
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+    uint8_t extra = 99;
+    EXPECT_FALSE(queue.enqueue(&extra, 1)); // Full, nothing is overwritten
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.dequeue(buffer, size));
+        EXPECT_EQ(size, 1u);
+        EXPECT_EQ(buffer[0], i);
+    }
+    EXPECT_FALSE(queue.dequeue(buffer, size));
+    EXPECT_TRUE(queue.enqueue(&extra, 1)); // The empty dequeue published the consumer's index
+}
+
+// Test case for one producer and one consumer running concurrently over many laps.
+TEST(SPSCQueueTest, ProducerConsumerInOrder) {
+    const uint64_t numMessages = 200000;
+    SPSCQueue queue(64);
+    bool inOrder = true;
+
+    std::thread consumer([&queue, &inOrder]() {
+        uint8_t buffer[64];
+        size_t size = 0;
+        for (uint64_t expected = 0; expected < numMessages;) {
+            if (queue.dequeue(buffer, size)) {
+                uint64_t value;
+                std::memcpy(&value, buffer, sizeof(value));
+                if (value != expected) inOrder = false;
+                ++expected;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (uint64_t i = 0; i < numMessages; ++i) {
+        uint8_t data[sizeof(i)];
+        std::memcpy(data, &i, sizeof(i));
+        while (!queue.enqueue(data, sizeof(data))) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+
+    EXPECT_TRUE(inOrder);
+}
@@ -0,0 +1,68 @@
+#include "../src/spmc_stats_page.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Unique page name per test process, so parallel runs don't collide.
+static std::string testPageName(const std::string& suffix) {
+    return "/spmc_test_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+// Test case for publishing a snapshot and reading it back through a separate read-only mapping.
+TEST(StatsPageTest, PublishAndRead) {
+    SPMCQueue queue(8);
+    StatsPagePublisher publisher(queue, testPageName("publish"));
+    StatsPageReader reader(testPageName("publish"));
+
+    QueueStats stats;
+    uint64_t timestampNs = 0;
+    EXPECT_FALSE(reader.read(stats, timestampNs)); // Nothing published yet
+
+    uint8_t data[64];
+    std::memset(data, 1, sizeof(data));
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    publisher.publish();
+
+    ASSERT_TRUE(reader.read(stats, timestampNs));
+    EXPECT_EQ(stats.mCapacity, 8u);
+    EXPECT_EQ(stats.mHead, 2u);
+    EXPECT_EQ(stats.mTail, 0u);
+    EXPECT_EQ(stats.mDepth, 2u);
+    EXPECT_GT(timestampNs, 0u);
+#ifdef SPMC_ENABLE_STATS
+    EXPECT_EQ(stats.mPublished, 2u);
+#endif
+}
+
+// Test case for attaching to a page that does not exist.
+TEST(StatsPageTest, ReaderRejectsMissingPage) {
+    EXPECT_THROW(StatsPageReader reader(testPageName("missing")), std::runtime_error);
+}
+
+// Test case for a second publisher on a live page, and for recovering a page left behind.
+TEST(StatsPageTest, PublisherRequiresFreshPage) {
+    SPMCQueue queue(8);
+    StatsPagePublisher publisher(queue, testPageName("exclusive"));
+    EXPECT_THROW(StatsPagePublisher second(queue, testPageName("exclusive")), std::runtime_error);
+
+    int fd = shm_open(testPageName("stale").c_str(), O_CREAT | O_RDWR, 0644); // As left by a crash
+    ASSERT_GE(fd, 0);
+    close(fd);
+    EXPECT_THROW(StatsPagePublisher stale(queue, testPageName("stale")), std::runtime_error);
+    EXPECT_TRUE(removeStatsPage(testPageName("stale")));
+    EXPECT_NO_THROW(StatsPagePublisher recovered(queue, testPageName("stale")));
+}
+
+// Test case for attaching to an object too small to be a stats page, which must not fault.
+TEST(StatsPageTest, ReaderRejectsShortObject) {
+    int fd = shm_open(testPageName("short").c_str(), O_CREAT | O_RDWR, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, 16), 0);
+    close(fd);
+    EXPECT_THROW(StatsPageReader reader(testPageName("short")), std::runtime_error);
+    removeStatsPage(testPageName("short"));
+}
@@ -0,0 +1,95 @@
+#include "../src/strided_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Test case for the capacity check: every slot must belong to the same consumer on every lap.
+TEST(StridedSPMCQueueTest, RejectsCapacityNotMultipleOfConsumers) {
+    EXPECT_THROW(StridedSPMCQueue(10, 3), std::invalid_argument);
+    EXPECT_THROW(StridedSPMCQueue(8, 0), std::invalid_argument);
+    EXPECT_NO_THROW(StridedSPMCQueue(9, 3));
+}
+
+// Test case for the partitioning: consumer i receives positions i, i + N, i + 2N...
+TEST(StridedSPMCQueueTest, ConsumersReadTheirOwnStride) {
+    StridedSPMCQueue queue(6, 3);
+    for (uint8_t i = 0; i < 6; ++i) {
+        EXPECT_TRUE(queue.enqueue(&i, 1));
+    }
+
+    for (size_t c = 0; c < 3; ++c) {
+        StridedConsumer consumer(queue, c);
+        uint8_t buffer[64];
+        size_t size = 0;
+        EXPECT_TRUE(consumer.dequeue(buffer, size));
+        EXPECT_EQ(buffer[0], c);
+        EXPECT_TRUE(consumer.dequeue(buffer, size));
+        EXPECT_EQ(buffer[0], c + 3);
+        EXPECT_FALSE(consumer.dequeue(buffer, size));
+    }
+}
+
+// Test case for back-pressure: the producer cannot overwrite a slot its consumer has not read.
+TEST(StridedSPMCQueueTest, SlowConsumerBlocksOnlyItsSlot) {
+    StridedSPMCQueue queue(4, 2);
+    StridedConsumer first(queue, 0);
+    uint8_t data[8] = {};
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    }
+    EXPECT_FALSE(queue.enqueue(data, sizeof(data))); // Slot 0 still holds consumer 0's unread block
+
+    uint8_t buffer[64];
+    size_t size = 0;
+    EXPECT_TRUE(first.dequeue(buffer, size));
+    EXPECT_TRUE(queue.enqueue(data, sizeof(data)));
+    EXPECT_FALSE(queue.enqueue(data, sizeof(data))); // Slot 1 belongs to consumer 1, which has not read
+}
+
+// Test case for several consumers draining their partitions concurrently, across many laps.
+TEST(StridedSPMCQueueTest, EveryMessageArrivesOnce) {
+    const size_t numConsumers = 4;
+    const int numMessages = 20000;
+    StridedSPMCQueue queue(256, numConsumers);
+    std::vector<std::atomic<int>> seen(numMessages);
+    std::atomic<bool> inOrder(true);
+
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&queue, &seen, &inOrder, c]() {
+            StridedConsumer consumer(queue, c);
+            uint8_t buffer[64];
+            size_t size = 0;
+            for (int expected = static_cast<int>(c); expected < numMessages;) {
+                if (consumer.dequeue(buffer, size)) {
+                    int value;
+                    std::memcpy(&value, buffer, sizeof(value));
+                    if (value != expected) inOrder = false;
+                    seen[value].fetch_add(1);
+                    expected += numConsumers;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < numMessages; ++i) {
+        uint8_t data[sizeof(int)];
+        std::memcpy(data, &i, sizeof(i));
+        while (!queue.enqueue(data, sizeof(data))) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    EXPECT_TRUE(inOrder.load());
+    for (int i = 0; i < numMessages; ++i) {
+        EXPECT_EQ(seen[i].load(), 1) << "message " << i;
+    }
+}
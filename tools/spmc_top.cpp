@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "../src/spmc_stats_page.h"
+
+// spmc_top: live view of an SPMCQueue published with StatsPagePublisher.
+// The page is mapped read-only, so attaching to a production queue never perturbs it.
+//
+// Usage: spmc_top <page-name> [--interval=ms] [--once]
+
+namespace {
+
+double perSecond(uint64_t now, uint64_t before, double seconds) {
+    return seconds > 0.0 && now >= before ? static_cast<double>(now - before) / seconds : 0.0;
+}
+
+struct ConsumerHistory {
+    uint64_t mConsumed = 0;
+    uint64_t mLastProgressNs = 0;
+};
+
+void printSnapshot(const std::string& name, const QueueStats& stats, const QueueStats& previous,
+                   double seconds, uint64_t timestampNs, std::map<size_t, ConsumerHistory>& history) {
+    std::printf("spmc_top  %s  capacity %zu  stats %s\n", name.c_str(), stats.mCapacity,
+                stats.mEnabled ? "on" : "off (build with SPMC_ENABLE_STATS for counters)");
+    std::printf("head %zu  tail %zu  depth %zu (%.1f%% full)\n\n", stats.mHead, stats.mTail, stats.mDepth,
+                stats.mCapacity ? 100.0 * stats.mDepth / stats.mCapacity : 0.0);
+
+    std::printf("%-20s %16s %14s\n", "", "total", "per second");
+    std::printf("%-20s %16llu %14.0f\n", "published", (unsigned long long)stats.mPublished,
+                perSecond(stats.mPublished, previous.mPublished, seconds));
+    std::printf("%-20s %16llu %14.0f\n", "consumed", (unsigned long long)stats.mConsumed,
+                perSecond(stats.mConsumed, previous.mConsumed, seconds));
+    std::printf("%-20s %16llu %14.0f\n", "overwrites", (unsigned long long)stats.mOverwrites,
+                perSecond(stats.mOverwrites, previous.mOverwrites, seconds));
+    std::printf("%-20s %16llu %14.0f\n\n", "contention retries", (unsigned long long)stats.mContentionRetries,
+                perSecond(stats.mContentionRetries, previous.mContentionRetries, seconds));
+
+    // Consumers share one tail, so a consumer's lag shows up as the time since it last made progress
+    std::map<size_t, uint64_t> previousConsumed;
+    for (const ConsumerStats& consumer : previous.mConsumers) {
+        previousConsumed[consumer.mShard] = consumer.mConsumed;
+    }
+    std::printf("%-8s %16s %14s %8s %12s %10s\n", "shard", "consumed", "per second", "share", "retries", "idle (s)");
+    for (const ConsumerStats& consumer : stats.mConsumers) {
+        ConsumerHistory& entry = history[consumer.mShard];
+        if (consumer.mConsumed != entry.mConsumed || entry.mLastProgressNs == 0) {
+            entry.mConsumed = consumer.mConsumed;
+            entry.mLastProgressNs = timestampNs;
+        }
+        std::printf("%-8zu %16llu %14.0f %7.1f%% %12llu %10.1f\n", consumer.mShard,
+                    (unsigned long long)consumer.mConsumed,
+                    perSecond(consumer.mConsumed, previousConsumed[consumer.mShard], seconds),
+                    stats.mConsumed ? 100.0 * consumer.mConsumed / stats.mConsumed : 0.0,
+                    (unsigned long long)consumer.mContentionRetries,
+                    (timestampNs - entry.mLastProgressNs) / 1e9);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string name;
+    int intervalMs = 1000;
+    bool once = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--interval=", 0) == 0) {
+            intervalMs = std::stoi(arg.substr(11));
+        } else if (arg == "--once") {
+            once = true;
+        } else {
+            name = arg;
+        }
+    }
+    if (name.empty()) {
+        std::cerr << "Usage: spmc_top <page-name> [--interval=ms] [--once]\n";
+        return 2;
+    }
+
+    try {
+        StatsPageReader reader(name);
+        QueueStats previous;
+        QueueStats stats;
+        uint64_t previousNs = 0;
+        uint64_t timestampNs = 0;
+        std::map<size_t, ConsumerHistory> history;
+
+        while (true) {
+            if (!reader.read(stats, timestampNs)) {
+                std::cout << "waiting for the first snapshot of " << name << "\n";
+            } else {
+                double seconds = previousNs ? (timestampNs - previousNs) / 1e9 : 0.0;
+                if (!once) {
+                    std::printf("\033[2J\033[H");
+                }
+                printSnapshot(name, stats, previousNs ? previous : stats, seconds, timestampNs, history);
+                std::fflush(stdout);
+                previous = stats;
+                previousNs = timestampNs;
+                if (once) {
+                    return 0;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "spmc_top: " << e.what() << "\n";
+        return 1;
+    }
+}